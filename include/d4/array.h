@@ -159,15 +159,16 @@
   } \
   \
   d4_str_t d4_arr_##element_type_name##_join (const d4_arr_##element_type_name##_t self, unsigned char o1, const d4_str_t separator) { \
-    d4_str_t x = o1 == 0 ? d4_str_alloc(L",") : separator; \
-    d4_str_t result = (d4_str_t) {NULL, 0, false}; \
+    d4_str_t x = o1 == 0 ? (d4_str_t) {L",", 1, true, false} : separator; \
+    d4_str_builder_t result = d4_str_builder_alloc(0); \
     for (size_t i = 0; i < self.len; i++) { \
       const element_type element = self.data[i]; \
-      if (i != 0) result = d4_str_realloc(result, d4_str_concat(result, x)); \
-      result = d4_str_realloc(result, d4_str_concat(result, str_block)); \
+      d4_str_t element_str = str_block; \
+      if (i != 0) d4_str_builder_appendStr(&result, x); \
+      d4_str_builder_appendStr(&result, element_str); \
+      d4_str_free(element_str); \
     } \
-    if (o1 == 0) d4_str_free(x); \
-    return result; \
+    return d4_str_builder_finish(&result); \
   } \
   \
   element_type *d4_arr_##element_type_name##_last (d4_err_state_t *state, int line, int col, d4_arr_##element_type_name##_t *self) { \
@@ -300,18 +301,18 @@
   } \
   \
   d4_str_t d4_arr_##element_type_name##_str (const d4_arr_##element_type_name##_t self) { \
-    d4_str_t b = d4_str_alloc(L"]"); \
-    d4_str_t c = d4_str_alloc(L", "); \
-    d4_str_t r = d4_str_alloc(L"["); \
+    d4_str_t c = (d4_str_t) {L", ", 2, true, false}; \
+    d4_str_builder_t r = d4_str_builder_alloc(0); \
+    d4_str_builder_appendWchar(&r, L'['); \
     for (size_t i = 0; i < self.len; i++) { \
       const element_type element = self.data[i]; \
-      if (i != 0) r = d4_str_realloc(r, d4_str_concat(r, c)); \
-      r = d4_str_realloc(r, d4_str_concat(r, str_block)); \
+      d4_str_t element_str = str_block; \
+      if (i != 0) d4_str_builder_appendStr(&r, c); \
+      d4_str_builder_appendStr(&r, element_str); \
+      d4_str_free(element_str); \
     } \
-    r = d4_str_realloc(r, d4_str_concat(r, b)); \
-    d4_str_free(b); \
-    d4_str_free(c); \
-    return r; \
+    d4_str_builder_appendWchar(&r, L']'); \
+    return d4_str_builder_finish(&r); \
   }
 
 #endif
@@ -135,7 +135,7 @@
       it = it->next; \
     } \
     if (it == NULL) { \
-      d4_str_t message = d4_str_alloc(L"failed to find key '%ls'", id.data); \
+      d4_str_t message = d4_str_alloc(L"failed to find key '%.*ls'", (int) id.len, id.data); \
       d4_error_assign_generic(state, line, col, message); \
       d4_str_free(message); \
     } \
@@ -236,7 +236,7 @@
       it = it->next; \
     } \
     if (it == NULL) { \
-      d4_str_t message = d4_str_alloc(L"failed to remove key '%ls'", id.data); \
+      d4_str_t message = d4_str_alloc(L"failed to remove key '%.*ls'", (int) id.len, id.data); \
       d4_error_assign_generic(state, line, col, message); \
       d4_str_free(message); \
     } \
@@ -300,13 +300,12 @@
   \
   d4_str_t d4_map_##key_type_name##MS##value_type_name##ME_str (const d4_map_##key_type_name##MS##value_type_name##ME_t self) { \
     /* todo need better strategy to sort ASC */ \
-    d4_str_t s = d4_str_alloc(L": "); \
-    d4_str_t c = d4_str_alloc(L", "); \
-    d4_str_t b = d4_str_alloc(L"}"); \
-    d4_str_t r = d4_str_alloc(L"{"); \
-    d4_str_t result; \
+    d4_str_t s = (d4_str_t) {L": ", 2, true, false}; \
+    d4_str_t c = (d4_str_t) {L", ", 2, true, false}; \
+    d4_str_builder_t r = d4_str_builder_alloc(0); \
     d4_map_##key_type_name##MS##value_type_name##ME_pair_t *it; \
     size_t j = 0; \
+    d4_str_builder_appendWchar(&r, L'{'); \
     for (size_t i = 0; i < self.cap; i++) { \
       it = self.data[i]; \
       while (it != NULL) { \
@@ -315,32 +314,18 @@
         d4_str_t key_str = key_str_block; \
         d4_str_t value_str = value_str_block; \
         d4_str_t key_quoted = d4_str_quoted_escape(key_str); \
-        d4_str_t r_with_key; \
-        d4_str_t r_with_colon; \
-        d4_str_t r_with_val; \
-        if (j++ != 0) { \
-          d4_str_t r_with_comma = d4_str_concat(r, c); \
-          r = d4_str_realloc(r, r_with_comma); \
-          d4_str_free(r_with_comma); \
-        } \
-        r_with_key = d4_str_concat(r, key_quoted); \
-        r_with_colon = d4_str_concat(r_with_key, s); \
-        r_with_val = d4_str_concat(r_with_colon, value_str); \
-        r = d4_str_realloc(r, r_with_val); \
+        if (j++ != 0) d4_str_builder_appendStr(&r, c); \
+        d4_str_builder_appendStr(&r, key_quoted); \
+        d4_str_builder_appendStr(&r, s); \
+        d4_str_builder_appendStr(&r, value_str); \
         d4_str_free(key_str); \
         d4_str_free(value_str); \
-        d4_str_free(r_with_key); \
-        d4_str_free(r_with_colon); \
-        d4_str_free(r_with_val); \
+        d4_str_free(key_quoted); \
         it = it->next; \
       } \
     } \
-    result = d4_str_concat(r, b); \
-    d4_str_free(s); \
-    d4_str_free(c); \
-    d4_str_free(b); \
-    d4_str_free(r); \
-    return result; \
+    d4_str_builder_appendWchar(&r, L'}'); \
+    return d4_str_builder_finish(&r); \
   } \
   \
   d4_arr_##value_type_name##_t d4_map_##key_type_name##MS##value_type_name##ME_values (const d4_map_##key_type_name##MS##value_type_name##ME_t self) { \
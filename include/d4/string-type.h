@@ -20,8 +20,20 @@ typedef struct {
   /** Length of the string object. */
   size_t len;
 
-  /** Whether or not string is static. */
+  /**
+   * Whether or not string is static. Static strings are never deallocated, single ASCII character strings are static.
+   * Static data is never modified, d4_str_atMut detaches static shared data and rejects views.
+   */
   bool is_static;
+
+  /** Whether or not string data is a shared buffer with reference counter, such strings are copied by reference. */
+  bool is_shared;
 } d4_str_t;
 
+/**
+ * String that borrows data of another string instead of owning it, view is static and isn't null-terminated.
+ * View can be passed wherever string is read, it stays valid as long as the string it was taken from.
+ */
+typedef d4_str_t d4_str_view_t;
+
 #endif
@@ -12,6 +12,135 @@
 
 D4_ARRAY_DECLARE(str, d4_str_t)
 
+/**
+ * Sorts strings of the array in place in ascending order defined by d4_str_cmp, without going through comparator
+ * function object.
+ * @param self Array to sort.
+ * @return Reference to self.
+ */
+d4_arr_str_t *d4_arr_str_sortAsc (d4_arr_str_t *self);
+
+/**
+ * Callback that is used to classify wide characters of a string, e.g. d4_rune_isDigit.
+ * @param c Wide character to make a check against.
+ * @return Whether wide character satisfies the check.
+ */
+typedef bool (*d4_str_pred_cb) (wchar_t c);
+
+/** Structure representing growable buffer that is used to construct a string by appending parts to it. */
+typedef struct {
+  /** Characters appended so far. */
+  wchar_t *data;
+
+  /** Number of characters appended so far. */
+  size_t len;
+
+  /** Number of characters buffer can hold before it needs to grow. */
+  size_t cap;
+} d4_str_builder_t;
+
+/** Structure representing iterator over lines of a string, iterator doesn't allocate and yields views. */
+typedef struct {
+  /** String to iterate lines of. */
+  d4_str_t str;
+
+  /** Position where next line starts. */
+  size_t pos;
+
+  /** Whether to keep line breaks in yielded lines. */
+  bool keep_line_breaks;
+} d4_str_lines_iter_t;
+
+/** Structure representing multi-pattern automaton (Aho-Corasick) that is built once and finds all patterns in one pass. */
+typedef struct {
+  /** Internal representation of the automaton. */
+  void *ctx;
+
+  /** Number of patterns automaton was built from. */
+  size_t len;
+} d4_str_matcher_t;
+
+/** Structure representing match of a pattern found by multi-pattern automaton. */
+typedef struct {
+  /** Index of the matched pattern. */
+  size_t pattern;
+
+  /** Position of the match in the string. */
+  int32_t start;
+
+  /** Length of the match. */
+  int32_t len;
+} d4_str_match_t;
+
+/** Structure representing balanced tree of string chunks (rope) that concatenates, slices and inserts without copying the whole string. */
+typedef struct {
+  /** Internal representation of the tree, NULL for empty rope. */
+  void *ctx;
+
+  /** Number of characters in the rope. */
+  size_t len;
+} d4_str_rope_t;
+
+/** Structure representing iterator over chunks of a rope, iterator doesn't allocate and yields views. */
+typedef struct {
+  /** Rope to iterate chunks of. */
+  d4_str_rope_t rope;
+
+  /** Position where next chunk starts. */
+  size_t pos;
+} d4_str_rope_iter_t;
+
+/** Structure representing substring searcher that is compiled once from a needle and reused for many haystacks. */
+typedef struct {
+  /** Needle to search for. */
+  d4_str_t needle;
+
+  /** Shift table indexed by low byte of a character, only used for long needles, otherwise NULL. */
+  size_t *shift;
+} d4_str_searcher_t;
+
+/** Structure representing iterator over pieces of a string split by delimiter, iterator doesn't allocate and yields views. */
+typedef struct {
+  /** String to split. */
+  d4_str_t str;
+
+  /** Delimiter to split by, empty delimiter splits string into characters. */
+  d4_str_t delimiter;
+
+  /** Position where next piece starts. */
+  size_t pos;
+
+  /** Number of splits left before the rest of the string is yielded as the last piece. */
+  size_t splits;
+
+  /** Whether the last piece was already yielded. */
+  bool done;
+} d4_str_split_iter_t;
+
+/** Structure representing array of strings packed into one contiguous buffer, e.g. a column of tokenized records. */
+typedef struct {
+  /** Characters of all strings placed one after another, each string is followed by NUL character. */
+  wchar_t *data;
+
+  /** Offsets of strings in data buffer, one more than number of strings. Last offset is the size of data buffer. */
+  size_t *offsets;
+
+  /** Number of strings. */
+  size_t len;
+} d4_str_table_t;
+
+/** Structure representing statistics of the string interning table. */
+typedef struct {
+  /** Number of interning requests that returned already interned string. */
+  size_t hits;
+
+  /** Number of interning requests that added new string to the table. */
+  size_t misses;
+
+  /** Number of strings in the interning table. */
+  size_t len;
+} d4_str_intern_stats_t;
+
 /** Empty value that can be used when you need to initialize a string. */
 extern d4_str_t d4_str_empty_val;
 
@@ -31,8 +160,20 @@ d4_str_t d4_str_alloc (const wchar_t *fmt, ...);
  */
 d4_str_t d4_str_calloc (const wchar_t *self, size_t length);
 
+/**
+ * Appends string to the end of a string taking ownership of it. When string is not shared with other owners its buffer
+ * is reused and grown geometrically, so appending in a loop is amortized linear. Otherwise it works like
+ * d4_str_concat followed by d4_str_free.
+ * @param self String to append to, it should not be used after the call.
+ * @param other String to append.
+ * @return String with other string appended.
+ */
+d4_str_t d4_str_appendMove (d4_str_t self, const d4_str_t other);
+
 /**
  * Returns a wide character at specified position in string otherwise throws error if index more than string length.
+ * Data of the string may be shared with its copies, so returned character should only be read, use d4_str_atMut to
+ * modify it.
  * @param state Error state to assign error to.
  * @param line Source line number.
  * @param col Source line column.
@@ -42,6 +183,92 @@ d4_str_t d4_str_calloc (const wchar_t *self, size_t length);
  */
 wchar_t *d4_str_at (d4_err_state_t *state, int line, int col, const d4_str_t self, int32_t index);
 
+/**
+ * Returns a wide character at specified position in string for modification, otherwise throws error if index more than
+ * string length. Data shared with other strings (copies, interned and cached strings) is detached into a copy owned by
+ * the string first (copy-on-write), string views borrow their data and throw error instead.
+ * @param state Error state to assign error to.
+ * @param line Source line number.
+ * @param col Source line column.
+ * @param self The string to find a character in, replaced with its detached copy if needed.
+ * @param index Character position to search for.
+ * @return Found wide character in a specified string.
+ */
+wchar_t *d4_str_atMut (d4_err_state_t *state, int line, int col, d4_str_t *self, int32_t index);
+
+/**
+ * Checks whether every wide character of a string satisfies predicate. Classification functions of rune module are
+ * recognized and checked over blocks of characters without calling them.
+ * @param self String to check characters of.
+ * @param predicate Callback to check every wide character with.
+ * @return Whether every wide character satisfies predicate, true for empty string.
+ */
+bool d4_str_allOf (const d4_str_t self, d4_str_pred_cb predicate);
+
+/**
+ * Allocates string builder with initial capacity. Capacity of the builder grows geometrically when it's exceeded.
+ * @param cap Number of characters to reserve, can be zero.
+ * @return Newly allocated string builder.
+ */
+d4_str_builder_t d4_str_builder_alloc (size_t cap);
+
+/**
+ * Appends floating point number to string builder, formatted the same way as d4_f64_str.
+ * @param self String builder to append to.
+ * @param num Number to append.
+ */
+void d4_str_builder_appendFloat (d4_str_builder_t *self, double num);
+
+/**
+ * Appends decimal representation of integer to string builder.
+ * @param self String builder to append to.
+ * @param num Number to append.
+ */
+void d4_str_builder_appendInt (d4_str_builder_t *self, int64_t num);
+
+/**
+ * Appends string to string builder.
+ * @param self String builder to append to.
+ * @param str String to append.
+ */
+void d4_str_builder_appendStr (d4_str_builder_t *self, const d4_str_t str);
+
+/**
+ * Appends wide character to string builder.
+ * @param self String builder to append to.
+ * @param c Wide character to append.
+ */
+void d4_str_builder_appendWchar (d4_str_builder_t *self, wchar_t c);
+
+/**
+ * Turns contents of string builder into string without copying them. String builder is empty after this call.
+ * @param self String builder to finish.
+ * @return String with contents of string builder.
+ */
+d4_str_t d4_str_builder_finish (d4_str_builder_t *self);
+
+/**
+ * Deallocates string builder without producing a string.
+ * @param self String builder to deallocate.
+ */
+void d4_str_builder_free (d4_str_builder_t self);
+
+/**
+ * Compares two strings character by character in one pass bounded by the shorter string, then compares lengths.
+ * @param self String to compare from.
+ * @param rhs String to compare to.
+ * @return Negative number if string is less than right-hand string, positive if greater, zero if they're equal.
+ */
+int d4_str_cmp (const d4_str_t self, const d4_str_t rhs);
+
+/**
+ * Compares two strings ignoring case, characters are folded with simple case folding of Unicode while comparing.
+ * @param self String to compare from.
+ * @param rhs String to compare to.
+ * @return Negative number if string is less than right-hand string, positive if greater, zero if they're equal.
+ */
+int d4_str_cmpIgnoreCase (const d4_str_t self, const d4_str_t rhs);
+
 /**
  * Concatenates two string into one.
  * @param self First string for concatenation.
@@ -59,12 +286,21 @@ d4_str_t d4_str_concat (const d4_str_t self, const d4_str_t other);
 bool d4_str_contains (const d4_str_t self, const d4_str_t search);
 
 /**
- * Creates deep copy of the string.
+ * Creates copy of the string. Strings with shared data are copied by incrementing reference counter.
  * @param self String to create copy of.
- * @return Deep copy of the string.
+ * @return Copy of the string.
  */
 d4_str_t d4_str_copy (const d4_str_t self);
 
+/**
+ * Counts wide characters of a string that satisfy predicate. Classification functions of rune module are recognized
+ * and counted over blocks of characters without calling them.
+ * @param self String to count characters of.
+ * @param predicate Callback to check every wide character with.
+ * @return Number of wide characters that satisfy predicate.
+ */
+size_t d4_str_countIf (const d4_str_t self, d4_str_pred_cb predicate);
+
 /**
  * Checks whether string is empty.
  * @param self String to check.
@@ -80,6 +316,14 @@ bool d4_str_empty (const d4_str_t self);
  */
 bool d4_str_eq (const d4_str_t self, const d4_str_t rhs);
 
+/**
+ * Checks whether string is equal to other string ignoring case.
+ * @param self String to check.
+ * @param rhs Other string to check.
+ * @return Whether string is equal to other string ignoring case.
+ */
+bool d4_str_eqIgnoreCase (const d4_str_t self, const d4_str_t rhs);
+
 /**
  * Escapes all escapable characters in a string.
  * @param self String to escape.
@@ -95,6 +339,14 @@ d4_str_t d4_str_escape (const d4_str_t self);
  */
 int32_t d4_str_find (const d4_str_t self, const d4_str_t search);
 
+/**
+ * Finds substring in a string ignoring case.
+ * @param self String to search in.
+ * @param search String to search for.
+ * @return Position of found string, -1 otherwise.
+ */
+int32_t d4_str_findIgnoreCase (const d4_str_t self, const d4_str_t search);
+
 /**
  * Deallocates string.
  * @param self String to deallocate.
@@ -117,6 +369,28 @@ bool d4_str_ge (const d4_str_t self, const d4_str_t rhs);
  */
 bool d4_str_gt (const d4_str_t self, const d4_str_t rhs);
 
+/**
+ * Generates FNV hash of a string. Hash of a string with shared data is computed once and cached alongside the data, so
+ * copies of the string share it and d4_str_eq uses it to reject mismatching strings without comparing data.
+ * @param self String to generate hash for.
+ * @return Hash of the string.
+ */
+size_t d4_str_hash (const d4_str_t self);
+
+/**
+ * Returns canonical instance of the string that lives until the program exits. Interned strings with the same data share
+ * one buffer, so they are compared by pointer. Copying or deallocating interned string has no effect. Thread-safe.
+ * @param self String to intern.
+ * @return Interned instance of the string.
+ */
+d4_str_t d4_str_intern (const d4_str_t self);
+
+/**
+ * Returns statistics of the string interning table. Thread-safe.
+ * @return Statistics of the string interning table.
+ */
+d4_str_intern_stats_t d4_str_intern_stats (void);
+
 /**
  * Checks whether string is less than or equal to right-hand string.
  * @param self String to compare.
@@ -134,6 +408,23 @@ bool d4_str_le (const d4_str_t self, const d4_str_t rhs);
  */
 d4_arr_str_t d4_str_lines (const d4_str_t self, unsigned char o1, bool keepLineBreaks);
 
+/**
+ * Creates iterator over lines of the string, lines are split the same way as in d4_str_lines.
+ * @param self String to iterate lines of, should outlive the iterator.
+ * @param o1 Whether or not `keepLineBreaks` parameter is specified.
+ * @param keepLineBreaks Whether to keep line breaks in yielded lines.
+ * @return Iterator positioned before the first line.
+ */
+d4_str_lines_iter_t d4_str_lines_iter (const d4_str_t self, unsigned char o1, bool keepLineBreaks);
+
+/**
+ * Advances lines iterator to the next line.
+ * @param self Lines iterator to advance.
+ * @param line Pointer to store view of the next line into.
+ * @return Whether there was a next line.
+ */
+bool d4_str_lines_iter_next (d4_str_lines_iter_t *self, d4_str_view_t *line);
+
 /**
  * Creates and returns representation of the string in lowercase.
  * @param self String to create representation for.
@@ -148,6 +439,14 @@ d4_str_t d4_str_lower (const d4_str_t self);
  */
 d4_str_t d4_str_lowerFirst (const d4_str_t self);
 
+/**
+ * Transforms string into lowercase taking ownership of it. Buffer of the string is reused when string is not shared
+ * with other owners, otherwise it works like d4_str_lower followed by d4_str_free.
+ * @param self String to transform, it should not be used after the call.
+ * @return Lowercase representation of the string.
+ */
+d4_str_t d4_str_lowerInPlace (d4_str_t self);
+
 /**
  * Checks whether string is less than right-hand string.
  * @param self String to compare.
@@ -163,6 +462,39 @@ bool d4_str_lt (const d4_str_t self, const d4_str_t rhs);
  */
 bool d4_str_not (const d4_str_t self);
 
+/**
+ * Builds multi-pattern automaton from patterns. Empty patterns never match.
+ * @param patterns Patterns to search for.
+ * @return Newly allocated multi-pattern automaton.
+ */
+d4_str_matcher_t d4_str_matcher_alloc (const d4_arr_str_t patterns);
+
+/**
+ * Finds non-overlapping matches of all patterns in one pass. When several patterns match, the leftmost match wins, the
+ * longest one if they start at the same position.
+ * @param self Multi-pattern automaton to search with.
+ * @param haystack String to search in.
+ * @param matches Buffer to write matches to, can be NULL if `cap` is zero.
+ * @param cap Maximum number of matches to write.
+ * @return Number of matches, might be more than `cap`.
+ */
+size_t d4_str_matcher_findAll (const d4_str_matcher_t self, const d4_str_t haystack, d4_str_match_t *matches, size_t cap);
+
+/**
+ * Deallocates multi-pattern automaton.
+ * @param self Multi-pattern automaton to deallocate.
+ */
+void d4_str_matcher_free (d4_str_matcher_t self);
+
+/**
+ * Replaces matches of all patterns in one pass, matches are chosen the same way as in d4_str_matcher_findAll.
+ * @param self Multi-pattern automaton to search with.
+ * @param haystack String to replace in.
+ * @param replacements Replacement for each pattern at the same index, patterns without replacement are removed.
+ * @return String with replaced patterns.
+ */
+d4_str_t d4_str_matcher_replace (const d4_str_matcher_t self, const d4_str_t haystack, const d4_arr_str_t replacements);
+
 /**
  * Puts string into double quotes and escapes characters inside of it.
  * @param self String to quote.
@@ -189,6 +521,111 @@ d4_str_t d4_str_realloc (d4_str_t self, const d4_str_t rhs);
  */
 d4_str_t d4_str_replace (const d4_str_t self, const d4_str_t search, const d4_str_t replacement, unsigned char o3, int32_t count);
 
+/**
+ * Replaces occurrences of search string taking ownership of the string. Replacement is done within buffer of the string
+ * when string is not shared with other owners and replacement is not longer than search string, otherwise it works
+ * like d4_str_replace followed by d4_str_free.
+ * @param self String to replace occurrences in, it should not be used after the call.
+ * @param search String to search for.
+ * @param replacement String to replace with.
+ * @param o3 Whether or not `count` parameter is specified.
+ * @param count Maximum number of replacements, all occurrences are replaced when zero or negative.
+ * @return String with occurrences replaced.
+ */
+d4_str_t d4_str_replaceInto (d4_str_t self, const d4_str_t search, const d4_str_t replacement, unsigned char o3, int32_t count);
+
+/**
+ * Allocates rope that consists of one string. String data is shared with the rope, not copied.
+ * @param str String to create rope from.
+ * @return Newly allocated rope.
+ */
+d4_str_rope_t d4_str_rope_alloc (const d4_str_t str);
+
+/**
+ * Creates rope with string appended to the end, small chunks are merged together as they are appended.
+ * @param self Rope to append to, it's left unchanged.
+ * @param str String to append.
+ * @return Newly allocated rope that shares the tree with the original one.
+ */
+d4_str_rope_t d4_str_rope_append (const d4_str_rope_t self, const d4_str_t str);
+
+/**
+ * Returns a wide character at specified position in rope in O(log n) otherwise throws error if index more than rope length.
+ * @param state Error state to assign error to.
+ * @param line Source line number.
+ * @param col Source line column.
+ * @param self The rope to find a character in.
+ * @param index Character position to search for, negative position is counted from the end.
+ * @return Found wide character.
+ */
+wchar_t d4_str_rope_at (d4_err_state_t *state, int line, int col, const d4_str_rope_t self, int32_t index);
+
+/**
+ * Concatenates two ropes in O(log n) without copying characters.
+ * @param self Rope to concatenate from.
+ * @param other Rope to concatenate with.
+ * @return Newly allocated rope that shares the trees with both ropes.
+ */
+d4_str_rope_t d4_str_rope_concat (const d4_str_rope_t self, const d4_str_rope_t other);
+
+/**
+ * Copies rope, the tree is shared and only reference count is increased.
+ * @param self Rope to copy.
+ * @return Copied rope.
+ */
+d4_str_rope_t d4_str_rope_copy (const d4_str_rope_t self);
+
+/**
+ * Deallocates rope, strings of the rope are deallocated when no other rope references them.
+ * @param self Rope to deallocate.
+ */
+void d4_str_rope_free (d4_str_rope_t self);
+
+/**
+ * Creates rope with string inserted at specified position in O(log n) otherwise throws error if index more than rope length.
+ * @param state Error state to assign error to.
+ * @param line Source line number.
+ * @param col Source line column.
+ * @param self Rope to insert into, it's left unchanged.
+ * @param index Position to insert at, negative position is counted from the end.
+ * @param str String to insert.
+ * @return Newly allocated rope that shares the tree with the original one.
+ */
+d4_str_rope_t d4_str_rope_insert (d4_err_state_t *state, int line, int col, const d4_str_rope_t self, int32_t index, const d4_str_t str);
+
+/**
+ * Creates iterator over chunks of a rope, e.g. to write rope out without flattening it. Rope should outlive iterator.
+ * @param self Rope to iterate chunks of.
+ * @return Iterator positioned before the first chunk.
+ */
+d4_str_rope_iter_t d4_str_rope_iter (const d4_str_rope_t self);
+
+/**
+ * Advances iterator to the next chunk of a rope.
+ * @param self Iterator to advance.
+ * @param chunk View to store the chunk into, it points into rope data.
+ * @return Whether chunk was yielded, false when rope is exhausted.
+ */
+bool d4_str_rope_iter_next (d4_str_rope_iter_t *self, d4_str_view_t *chunk);
+
+/**
+ * Creates slice of the rope in O(log n) without copying characters.
+ * @param self Rope to take slice of.
+ * @param o1 Whether or not `start` parameter is specified.
+ * @param start Start of the slice.
+ * @param o2 Whether or not `end` parameter is specified.
+ * @param end End of the slice.
+ * @return Newly allocated rope that shares the tree with the original one.
+ */
+d4_str_rope_t d4_str_rope_slice (const d4_str_rope_t self, unsigned char o1, int32_t start, unsigned char o2, int32_t end);
+
+/**
+ * Flattens rope into a string, rope that consists of one whole string returns that string without copying.
+ * @param self Rope to flatten.
+ * @return String with all characters of the rope.
+ */
+d4_str_t d4_str_rope_str (const d4_str_rope_t self);
+
 /**
  * Creates and returns slice of the string.
  * @param self String to take slice of.
@@ -200,6 +637,67 @@ d4_str_t d4_str_replace (const d4_str_t self, const d4_str_t search, const d4_st
  */
 d4_str_t d4_str_slice (const d4_str_t self, unsigned char o1, int32_t start, unsigned char o2, int32_t end);
 
+/**
+ * Returns slice of the string as a view without copying it.
+ * @param self String to take slice of.
+ * @param o1 Whether or not `start` parameter is specified.
+ * @param start Start of the slice.
+ * @param o2 Whether or not `end` parameter is specified.
+ * @param end End of the slice.
+ * @return View of the slice of the string provided.
+ */
+d4_str_view_t d4_str_sliceView (const d4_str_t self, unsigned char o1, int32_t start, unsigned char o2, int32_t end);
+
+/**
+ * Compiles substring searcher from a needle.
+ * @param needle String to search for.
+ * @return Newly allocated substring searcher.
+ */
+d4_str_searcher_t d4_str_searcher_alloc (const d4_str_t needle);
+
+/**
+ * Counts non-overlapping occurrences of searcher needle in string.
+ * @param self Substring searcher to search with.
+ * @param haystack String to search in.
+ * @return Number of occurrences.
+ */
+size_t d4_str_searcher_count (const d4_str_searcher_t self, const d4_str_t haystack);
+
+/**
+ * Finds first occurrence of searcher needle in string.
+ * @param self Substring searcher to search with.
+ * @param haystack String to search in.
+ * @return Position of the first occurrence, or -1 if not found.
+ */
+int32_t d4_str_searcher_find (const d4_str_searcher_t self, const d4_str_t haystack);
+
+/**
+ * Finds non-overlapping occurrences of searcher needle in string.
+ * @param self Substring searcher to search with.
+ * @param haystack String to search in.
+ * @param positions Buffer to write positions of occurrences to, can be NULL if `cap` is zero.
+ * @param cap Maximum number of positions to write.
+ * @return Number of occurrences, might be more than `cap`.
+ */
+size_t d4_str_searcher_findAll (const d4_str_searcher_t self, const d4_str_t haystack, int32_t *positions, size_t cap);
+
+/**
+ * Deallocates substring searcher.
+ * @param self Substring searcher to deallocate.
+ */
+void d4_str_searcher_free (d4_str_searcher_t self);
+
+/**
+ * Replaces searcher needle with replacement in string provided, works the same way as d4_str_replace.
+ * @param self Substring searcher to search with.
+ * @param haystack String to replace in.
+ * @param replacement String to replace with.
+ * @param o3 Whether or not `count` parameter is specified.
+ * @param count How many occurrences to replace. If less than or equal to zero - then it will act as if parameter was not passed.
+ * @return String with replaced needle.
+ */
+d4_str_t d4_str_searcher_replace (const d4_str_searcher_t self, const d4_str_t haystack, const d4_str_t replacement, unsigned char o3, int32_t count);
+
 /**
  * Splits string into array of string by provided delimiter.
  * @param self String to take slice of.
@@ -209,6 +707,96 @@ d4_str_t d4_str_slice (const d4_str_t self, unsigned char o1, int32_t start, uns
  */
 d4_arr_str_t d4_str_split (const d4_str_t self, unsigned char o1, const d4_str_t delimiter);
 
+/**
+ * Splits string into array of views by provided delimiter, only the array itself is allocated.
+ * @param self String to split.
+ * @param o1 Whether or not `delimiter` parameter is specified.
+ * @param delimiter Delimiter substring to split string by.
+ * @return String split into array of views.
+ */
+d4_arr_str_t d4_str_splitView (const d4_str_t self, unsigned char o1, const d4_str_t delimiter);
+
+/**
+ * Creates iterator over pieces of the string, pieces are split the same way as in d4_str_split.
+ * @param self String to split, should outlive the iterator.
+ * @param o1 Whether or not `delimiter` parameter is specified.
+ * @param delimiter Delimiter substring to split string by, should outlive the iterator.
+ * @param o2 Whether or not `maxSplits` parameter is specified.
+ * @param maxSplits How many times to split at most, the rest of the string is yielded as the last piece. If less than
+ *   or equal to zero - then it will act as if parameter was not passed.
+ * @return Iterator positioned before the first piece.
+ */
+d4_str_split_iter_t d4_str_split_iter (
+  const d4_str_t self,
+  unsigned char o1,
+  const d4_str_t delimiter,
+  unsigned char o2,
+  int32_t maxSplits
+);
+
+/**
+ * Advances split iterator to the next piece.
+ * @param self Split iterator to advance.
+ * @param piece Pointer to store view of the next piece into.
+ * @return Whether there was a next piece.
+ */
+bool d4_str_split_iter_next (d4_str_split_iter_t *self, d4_str_view_t *piece);
+
+/**
+ * Packs strings of the array into string table with a single allocation for characters.
+ * @param arr Array of strings to pack.
+ * @return Newly allocated string table.
+ */
+d4_str_table_t d4_str_table_alloc (const d4_arr_str_t arr);
+
+/**
+ * Returns string at specified position in string table otherwise throws error if index more than number of strings.
+ * @param state Error state to assign error to.
+ * @param line Source line number.
+ * @param col Source line column.
+ * @param self String table to take string from.
+ * @param index Position of the string, negative index counts from the end.
+ * @return View of the string that stays valid as long as the string table, view is NUL-terminated.
+ */
+d4_str_view_t d4_str_table_at (d4_err_state_t *state, int line, int col, const d4_str_table_t self, int32_t index);
+
+/**
+ * Checks whether string table contains a string.
+ * @param self String table to search in.
+ * @param search String to search for.
+ * @return Whether string table contains the string.
+ */
+bool d4_str_table_contains (const d4_str_table_t self, const d4_str_t search);
+
+/**
+ * Deallocates string table.
+ * @param self String table to deallocate.
+ */
+void d4_str_table_free (d4_str_table_t self);
+
+/**
+ * Joins strings of string table with separator, result is allocated once with exact size.
+ * @param self String table to join.
+ * @param o1 Whether or not `separator` parameter is specified.
+ * @param separator Separator to put between strings, defaults to comma.
+ * @return Joined string.
+ */
+d4_str_t d4_str_table_join (const d4_str_table_t self, unsigned char o1, const d4_str_t separator);
+
+/**
+ * Sorts strings of string table lexicographically by character codes, shorter string goes first when one string is a
+ * prefix of another.
+ * @param self String table to sort.
+ */
+void d4_str_table_sort (d4_str_table_t *self);
+
+/**
+ * Converts string table into array of strings without copying characters.
+ * @param self String table to convert.
+ * @return Array of views that stay valid as long as the string table.
+ */
+d4_arr_str_t d4_str_table_toArr (const d4_str_table_t self);
+
 /**
  * Converts string into float representation.
  * @param state Error state to assign error to.
@@ -219,6 +807,16 @@ d4_arr_str_t d4_str_split (const d4_str_t self, unsigned char o1, const d4_str_t
  */
 double d4_str_toFloat (d4_err_state_t *state, int line, int col, const d4_str_t self);
 
+/**
+ * Converts every string of the array into float representation, stops at the first string that fails to convert.
+ * @param state Error state to assign error to.
+ * @param line Source line number.
+ * @param col Source line column.
+ * @param self Array of strings to convert.
+ * @param result Buffer to write float representations into, should hold at least as many elements as the array.
+ */
+void d4_str_toFloatAll (d4_err_state_t *state, int line, int col, const d4_arr_str_t self, double *result);
+
 /**
  * Converts string into f32 representation.
  * @param state Error state to assign error to.
@@ -229,6 +827,16 @@ double d4_str_toFloat (d4_err_state_t *state, int line, int col, const d4_str_t
  */
 float d4_str_toF32 (d4_err_state_t *state, int line, int col, const d4_str_t self);
 
+/**
+ * Converts every string of the array into f32 representation, stops at the first string that fails to convert.
+ * @param state Error state to assign error to.
+ * @param line Source line number.
+ * @param col Source line column.
+ * @param self Array of strings to convert.
+ * @param result Buffer to write f32 representations into, should hold at least as many elements as the array.
+ */
+void d4_str_toF32All (d4_err_state_t *state, int line, int col, const d4_arr_str_t self, float *result);
+
 /**
  * Converts string into f64 representation.
  * @param state Error state to assign error to.
@@ -239,6 +847,16 @@ float d4_str_toF32 (d4_err_state_t *state, int line, int col, const d4_str_t sel
  */
 double d4_str_toF64 (d4_err_state_t *state, int line, int col, const d4_str_t self);
 
+/**
+ * Converts every string of the array into f64 representation, stops at the first string that fails to convert.
+ * @param state Error state to assign error to.
+ * @param line Source line number.
+ * @param col Source line column.
+ * @param self Array of strings to convert.
+ * @param result Buffer to write f64 representations into, should hold at least as many elements as the array.
+ */
+void d4_str_toF64All (d4_err_state_t *state, int line, int col, const d4_arr_str_t self, double *result);
+
 /**
  * Converts string into isize representation.
  * @param state Error state to assign error to.
@@ -373,6 +991,21 @@ d4_str_t d4_str_trim (const d4_str_t self);
  */
 d4_str_t d4_str_trimEnd (const d4_str_t self);
 
+/**
+ * Returns view of the string with whitespaces removed from the end of the string provided.
+ * @param self String to remove whitespace from.
+ * @return View of the string without trailing whitespaces.
+ */
+d4_str_view_t d4_str_trimEndView (const d4_str_t self);
+
+/**
+ * Removes whitespaces from both ends of a string taking ownership of it. Characters are moved within buffer of the
+ * string when string is not shared with other owners, otherwise it works like d4_str_trim followed by d4_str_free.
+ * @param self String to trim, it should not be used after the call.
+ * @return Trimmed string.
+ */
+d4_str_t d4_str_trimInPlace (d4_str_t self);
+
 /**
  * Creates and returns string with whitespaces removed from the beginning of the string provided.
  * @param self String to remove whitespace from.
@@ -380,6 +1013,20 @@ d4_str_t d4_str_trimEnd (const d4_str_t self);
  */
 d4_str_t d4_str_trimStart (const d4_str_t self);
 
+/**
+ * Returns view of the string with whitespaces removed from the beginning of the string provided.
+ * @param self String to remove whitespace from.
+ * @return View of the string without leading whitespaces.
+ */
+d4_str_view_t d4_str_trimStartView (const d4_str_t self);
+
+/**
+ * Returns view of the string with whitespaces removed from both ends of the string provided.
+ * @param self String to remove whitespace from.
+ * @return View of the string without leading and trailing whitespaces.
+ */
+d4_str_view_t d4_str_trimView (const d4_str_t self);
+
 /**
  * Creates and returns representation of the string in uppercase.
  * @param self String to create representation for.
@@ -394,4 +1041,12 @@ d4_str_t d4_str_upper (const d4_str_t self);
  */
 d4_str_t d4_str_upperFirst (const d4_str_t self);
 
+/**
+ * Transforms string into uppercase taking ownership of it. Buffer of the string is reused when string is not shared
+ * with other owners, otherwise it works like d4_str_upper followed by d4_str_free.
+ * @param self String to transform, it should not be used after the call.
+ * @return Uppercase representation of the string.
+ */
+d4_str_t d4_str_upperInPlace (d4_str_t self);
+
 #endif
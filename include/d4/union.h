@@ -53,7 +53,7 @@
   \
   d4_str_t d4_union_##subtypes_type_name##UE_str (const d4_union_##subtypes_type_name##UE_t self) { \
     str_block \
-    return (d4_str_t) {NULL, 0, false}; \
+    return (d4_str_t) {NULL, 0, false, false}; \
   }
 
 #endif
@@ -5,39 +5,44 @@
 
 #include "char.h"
 #include <d4/safe.h>
-#include <ctype.h>
+#include "rune.h"
 #include "string.h"
 
+// Returns properties of ASCII characters, bytes above ASCII range have no properties.
+static unsigned char char_props (char self) {
+  return (unsigned char) self < 0x80 ? d4_rune_props((wchar_t) self) : 0;
+}
+
 unsigned char d4_char_byte (char self) {
   return (unsigned char) self;
 }
 
 bool d4_char_isDigit (char self) {
-  return isdigit(self);
+  return (char_props(self) & D4_RUNE_DIGIT) != 0;
 }
 
 bool d4_char_isLetter (char self) {
-  return isalpha(self);
+  return (char_props(self) & D4_RUNE_LETTER) != 0;
 }
 
 bool d4_char_isLetterOrDigit (char self) {
-  return isalnum(self);
+  return (char_props(self) & (D4_RUNE_LETTER | D4_RUNE_DIGIT)) != 0;
 }
 
 bool d4_char_isLower (char self) {
-  return islower(self);
+  return (char_props(self) & D4_RUNE_LOWER) != 0;
 }
 
 bool d4_char_isUpper (char self) {
-  return isupper(self);
+  return (char_props(self) & D4_RUNE_UPPER) != 0;
 }
 
 bool d4_char_isWhitespace (char self) {
-  return isspace(self);
+  return (char_props(self) & D4_RUNE_WHITESPACE) != 0;
 }
 
 char d4_char_lower (char self) {
-  return (char) tolower(self);
+  return self >= 'A' && self <= 'Z' ? (char) (self + 0x20) : self;
 }
 
 d4_str_t d4_char_repeat (char self, int32_t times) {
@@ -47,14 +52,14 @@ d4_str_t d4_char_repeat (char self, int32_t times) {
   l = (size_t) times;
   d = d4_safe_alloc(l * sizeof(wchar_t));
   for (size_t i = 0; i < l; i++) d[i] = (wchar_t) self;
-  return (d4_str_t) {d, l, false};
+  return (d4_str_t) {d, l, false, false};
 }
 
 d4_str_t d4_char_str (char self) {
-  wchar_t buf[2] = {self, '\0'};
-  return d4_str_alloc(buf);
+  wchar_t c = (wchar_t) self;
+  return d4_str_calloc(&c, 1);
 }
 
 char d4_char_upper (char self) {
-  return (char) toupper(self);
+  return self >= 'a' && self <= 'z' ? (char) (self - 0x20) : self;
 }
@@ -14,7 +14,7 @@ d4_err_state_t d4_err_state = {-1, NULL, NULL, NULL, NULL, NULL, NULL};
 // LCOV_EXCL_START
 void d4_error_alloc (d4_err_state_t *state, size_t size) {
   wchar_t d[4096];
-  d4_str_t stack = (d4_str_t) {d, sizeof(d) / sizeof(d[0]), true};
+  d4_str_t stack = (d4_str_t) {d, sizeof(d) / sizeof(d[0]), true, false};
   d4_error_stack_str(state, &stack, stack.len);
   fwprintf(stderr, L"Allocation Error: failed to allocate %zu bytes%s" D4_EOL, size, d);
   exit(EXIT_FAILURE);
@@ -90,35 +90,32 @@ void d4_error_stack_push (d4_err_state_t *state, const wchar_t *file, const wcha
 
 void d4_error_stack_str (d4_err_state_t *state, d4_str_t *err, size_t max_len) {
   for (d4_err_stack_t *it = state->stack_last; it != NULL; it = it->prev) {
-    wchar_t *fmt;
-    size_t z;
+    d4_str_t line;
 
     if (it->col == 0 && it->line == 0) {
-      fmt = D4_EOL L"  at %ls (%ls)";
-      z = (size_t) snwprintf(fmt, it->name, it->file);
+      line = d4_str_alloc(D4_EOL L"  at %ls (%ls)", it->name, it->file);
     } else if (it->col == 0) {
-      fmt = D4_EOL L"  at %ls (%ls:%d)";
-      z = (size_t) snwprintf(fmt, it->name, it->file, it->line);
+      line = d4_str_alloc(D4_EOL L"  at %ls (%ls:%d)", it->name, it->file, it->line);
     } else {
-      fmt = D4_EOL L"  at %ls (%ls:%d:%d)";
-      z = (size_t) snwprintf(fmt, it->name, it->file, it->line, it->col);
+      line = d4_str_alloc(D4_EOL L"  at %ls (%ls:%d:%d)", it->name, it->file, it->line, it->col);
     }
 
-    if (max_len == 0) {
-      err->data = d4_safe_realloc(err->data, (err->len + z + 1) * sizeof(wchar_t));
-    } else if (err->len + z >= max_len) {
+    if (max_len == 0 && (err->is_static || err->is_shared)) {
+      wchar_t *d = d4_safe_alloc((err->len + line.len + 1) * sizeof(wchar_t));
+      if (err->len != 0) wmemcpy(d, err->data, err->len);
+      d4_str_free(*err);
+      *err = (d4_str_t) {d, err->len, false, false};
+    } else if (max_len == 0) {
+      err->data = d4_safe_realloc(err->data, (err->len + line.len + 1) * sizeof(wchar_t));
+    } else if (err->len + line.len >= max_len) {
+      d4_str_free(line); // LCOV_EXCL_LINE
       break; // LCOV_EXCL_LINE
     }
 
-    if (it->col == 0 && it->line == 0) {
-      swprintf(&err->data[err->len], z + 1, fmt, it->name, it->file);
-    } else if (it->col == 0) {
-      swprintf(&err->data[err->len], z + 1, fmt, it->name, it->file, it->line);
-    } else {
-      swprintf(&err->data[err->len], z + 1, fmt, it->name, it->file, it->line, it->col);
-    }
-
-    err->len += z;
+    wmemcpy(&err->data[err->len], line.data, line.len);
+    err->len += line.len;
+    err->data[err->len] = L'\0';
+    d4_str_free(line);
   }
 }
 
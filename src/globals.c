@@ -22,24 +22,27 @@ D4_FUNCTION_DEFINE_WITH_PARAMS(s, void, void, FP4arr_anyFP1strFP1strFP1str)
 
 static void print_func (D4_UNUSED void *ctx, void *params) {
   d4_fn_sFP4arr_anyFP1strFP1strFP1strFRvoidFE_params_t *p = params;
-  d4_str_t separator = p->o1 == 0 ? (d4_str_t) {L" ", 1, true} : p->n1;
-  d4_str_t terminator = p->o2 == 0 ? (d4_str_t) {PRINT_FUNC_TERMINATOR, PRINT_FUNC_TERMINATOR_LEN, true} : p->n2;
-  FILE *stream = d4_str_eq(p->n3, (d4_str_t) {L"stderr", 6, true}) ? stderr : stdout;
-  d4_str_t result = d4_str_empty_val;
+  d4_str_t separator = p->o1 == 0 ? (d4_str_t) {L" ", 1, true, false} : p->n1;
+  d4_str_t terminator = p->o2 == 0 ? (d4_str_t) {PRINT_FUNC_TERMINATOR, PRINT_FUNC_TERMINATOR_LEN, true, false} : p->n2;
+  FILE *stream = d4_str_eq(p->n3, (d4_str_t) {L"stderr", 6, true, false}) ? stderr : stdout;
+  d4_str_builder_t builder = d4_str_builder_alloc(0);
+  d4_str_t result;
 
   for (size_t i = 0; i < p->n0.len; i++) {
     d4_str_t param_str = d4_any_str(p->n0.data[i]);
-    if (i != 0) result = d4_str_realloc(result, d4_str_concat(result, separator));
-    result = d4_str_realloc(result, d4_str_concat(result, param_str));
+    if (i != 0) d4_str_builder_appendStr(&builder, separator);
+    d4_str_builder_appendStr(&builder, param_str);
+    d4_str_free(param_str);
   }
 
-  result = d4_str_realloc(result, d4_str_concat(result, terminator));
-  fwprintf(stream, result.data);
+  d4_str_builder_appendStr(&builder, terminator);
+  result = d4_str_builder_finish(&builder);
+  if (result.len != 0) fputws(result.data, stream);
   d4_str_free(result);
 }
 
 d4_fn_sFP4arr_anyFP1strFP1strFP1strFRvoidFE_t d4_print = {
-  (d4_str_t) {L"print", 4, true},
+  (d4_str_t) {L"print", 4, true, false},
   NULL,
   NULL,
   NULL,
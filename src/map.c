@@ -16,14 +16,7 @@ size_t d4_map_calc_cap (size_t cap, size_t len) {
 }
 
 size_t d4_map_hash (d4_str_t id, size_t cap) {
-  size_t result = 0xcbf29ce484222325;
-
-  for (size_t i = 0; i < id.len; i++) {
-    result *= 0x100000001b3;
-    result ^= (size_t) id.data[i];
-  }
-
-  return result % cap;
+  return d4_str_hash(id) % cap;
 }
 
 bool d4_map_should_reserve (size_t cap, size_t len) {
@@ -7,5 +7,42 @@
 #define SRC_NUMBER_H
 
 #include <d4/number.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/** Number of characters that is always enough to hold result of d4_float_write. */
+#define D4_FLOAT_BUF_LEN 350
+
+/** Number of characters that is always enough to hold result of d4_int_write. */
+#define D4_INT_BUF_LEN 21
+
+/**
+ * Parses decimal floating point number from the whole buffer without going through libc. Hexadecimal notation,
+ * infinity, NaN, numbers with more than 19 significant digits and results that are not normal numbers are not handled.
+ * @param data Buffer to parse, doesn't have to be NUL-terminated.
+ * @param len Length of the buffer.
+ * @param is_f32 Whether number should be rounded to single precision floating point number.
+ * @param result Pointer to store parsed number into.
+ * @return Whether number was parsed, caller should fall back to libc otherwise.
+ */
+bool d4_float_parse (const wchar_t *data, size_t len, bool is_f32, double *result);
+
+/**
+ * Writes shortest decimal representation of floating point number that parses back to the same value.
+ * @param buf Buffer to write into, should hold at least D4_FLOAT_BUF_LEN characters.
+ * @param self Number to write.
+ * @param is_f32 Whether number should round-trip as single precision floating point number.
+ * @return Number of characters written into buffer.
+ */
+size_t d4_float_write (wchar_t *buf, double self, bool is_f32);
+
+/**
+ * Writes decimal representation of integer number, buffer is not NUL-terminated.
+ * @param buf Buffer to write into, should hold at least D4_INT_BUF_LEN characters.
+ * @param self Absolute value of number to write.
+ * @param negative Whether number should be prefixed with minus sign.
+ * @return Number of characters written into buffer.
+ */
+size_t d4_int_write (wchar_t *buf, uint64_t self, bool negative);
 
 #endif
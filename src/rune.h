@@ -8,4 +8,34 @@
 
 #include <d4/rune.h>
 
+/** Property of decimal digit characters (general category Nd). */
+#define D4_RUNE_DIGIT 0x01
+
+/** Property of letter characters (general categories Lu, Ll, Lt, Lm and Lo). */
+#define D4_RUNE_LETTER 0x02
+
+/** Property of lowercase letter characters (general category Ll). */
+#define D4_RUNE_LOWER 0x04
+
+/** Property of uppercase letter characters (general category Lu). */
+#define D4_RUNE_UPPER 0x08
+
+/** Property of whitespace characters (White_Space property). */
+#define D4_RUNE_WHITESPACE 0x10
+
+/**
+ * Folds case of a wide character for case-insensitive comparison (simple case folding of Unicode). Characters that are
+ * equal ignoring case fold into the same character, e.g. 'K', 'k' and Kelvin sign.
+ * @param self Wide character to fold.
+ * @return Folded wide character.
+ */
+wchar_t d4_rune_fold (wchar_t self);
+
+/**
+ * Looks up Unicode properties of a wide character without consulting current locale.
+ * @param self Wide character to look up properties for.
+ * @return Bitset of D4_RUNE_* properties.
+ */
+unsigned char d4_rune_props (wchar_t self);
+
 #endif
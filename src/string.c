@@ -4,870 +4,2666 @@
  */
 
 #include "string.h"
+#include "number.h"
+#include "rune.h"
 #include <d4/array.h>
 #include <d4/macro.h>
-#include <ctype.h>
+#include <d4/map.h>
+#include <d4/number.h>
 #include <float.h>
 #include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
-D4_ARRAY_DEFINE(str, d4_str_t, d4_str_t, d4_str_copy(element), d4_str_eq(lhs_element, rhs_element), d4_str_free(element), d4_str_copy(element))
+#if defined(D4_OS_WINDOWS)
+  #include <windows.h>
+  #define STR_INTERN_LOCK() AcquireSRWLockExclusive(&str_intern_lock)
+  #define STR_INTERN_UNLOCK() ReleaseSRWLockExclusive(&str_intern_lock)
+#else
+  #include <pthread.h>
+  #define STR_INTERN_LOCK() pthread_mutex_lock(&str_intern_lock)
+  #define STR_INTERN_UNLOCK() pthread_mutex_unlock(&str_intern_lock)
+#endif
+
+#if defined(_MSC_VER)
+  #include <intrin.h>
+  #define STR_REFS_INCREMENT(x) _InterlockedIncrement(x)
+  #define STR_REFS_DECREMENT(x) _InterlockedDecrement(x)
+
+  #if defined(_WIN64)
+    #define STR_HASH_LOAD(x) ((size_t) _InterlockedOr64((volatile __int64 *) (x), 0))
+    #define STR_HASH_STORE(x, v) _InterlockedExchange64((volatile __int64 *) (x), (__int64) (v))
+  #else
+    #define STR_HASH_LOAD(x) ((size_t) _InterlockedOr((volatile long *) (x), 0))
+    #define STR_HASH_STORE(x, v) _InterlockedExchange((volatile long *) (x), (long) (v))
+  #endif
+#else
+  #define STR_REFS_INCREMENT(x) __atomic_add_fetch(x, 1, __ATOMIC_RELAXED)
+  #define STR_REFS_DECREMENT(x) __atomic_sub_fetch(x, 1, __ATOMIC_ACQ_REL)
+  #define STR_HASH_LOAD(x) __atomic_load_n(x, __ATOMIC_RELAXED)
+  #define STR_HASH_STORE(x, v) __atomic_store_n(x, v, __ATOMIC_RELAXED)
+#endif
+
+#if defined(__x86_64__) || defined(_M_X64)
+  #include <emmintrin.h>
+  #define STR_SEARCH_SSE2
+  #define STR_SEARCH_LANE_MASK ((1U << sizeof(wchar_t)) - 1U)
+  #define STR_SEARCH_LANES_128 (sizeof(__m128i) / sizeof(wchar_t))
+
+  #if WCHAR_MAX > 0xFFFF
+    #define STR_SEARCH_SET1_128(x) _mm_set1_epi32((int) (x))
+    #define STR_SEARCH_CMPEQ_128(a, b) _mm_cmpeq_epi32(a, b)
+    #define STR_SEARCH_CMPGT_128(a, b) _mm_cmpgt_epi32(a, b)
+  #else
+    #define STR_SEARCH_SET1_128(x) _mm_set1_epi16((short) (x))
+    #define STR_SEARCH_CMPEQ_128(a, b) _mm_cmpeq_epi16(a, b)
+    #define STR_SEARCH_CMPGT_128(a, b) _mm_cmpgt_epi16(a, b)
+  #endif
+#endif
+
+#if defined(STR_SEARCH_SSE2) && defined(__GNUC__)
+  #include <immintrin.h>
+  #define STR_SEARCH_AVX2
+  #define STR_SEARCH_LANES_256 (sizeof(__m256i) / sizeof(wchar_t))
+
+  #if WCHAR_MAX > 0xFFFF
+    #define STR_SEARCH_SET1_256(x) _mm256_set1_epi32((int) (x))
+    #define STR_SEARCH_CMPEQ_256(a, b) _mm256_cmpeq_epi32(a, b)
+  #else
+    #define STR_SEARCH_SET1_256(x) _mm256_set1_epi16((short) (x))
+    #define STR_SEARCH_CMPEQ_256(a, b) _mm256_cmpeq_epi16(a, b)
+  #endif
+#endif
+
+D4_ARRAY_DEFINE(str, d4_str_t, d4_str_t, d4_str_copy(element), d4_str_eq_hashed(lhs_element, rhs_element), d4_str_free(element), d4_str_copy(element))
+
+d4_str_t d4_str_empty_val = {NULL, 0, false, false};
+
+#define STR_ALLOC_BUF_LEN 64
+#define STR_BUILDER_MIN_CAP 16
+#define STR_FORMAT_FLOAT_BUF_LEN 512
+#define STR_FORMAT_LENGTH_NONE 0
+#define STR_FORMAT_LENGTH_HH 1
+#define STR_FORMAT_LENGTH_H 2
+#define STR_FORMAT_LENGTH_L 3
+#define STR_FORMAT_LENGTH_LL 4
+#define STR_FORMAT_LENGTH_Z 5
+#define STR_PARSE_CHUNK_LEN 8
+#define STR_ROPE_LEAF_LEN 128
+#define STR_SEARCH_TWO_WAY_MIN 32
+#define STR_SEARCHER_SHIFT_LEN 0x100
+#define STR_TINY(c) {{1, 0, 1, false}, {(c), L'\0'}}
+#define STR_TINY_ROW(n) \
+  STR_TINY((n) + 0x0), STR_TINY((n) + 0x1), STR_TINY((n) + 0x2), STR_TINY((n) + 0x3), \
+  STR_TINY((n) + 0x4), STR_TINY((n) + 0x5), STR_TINY((n) + 0x6), STR_TINY((n) + 0x7), \
+  STR_TINY((n) + 0x8), STR_TINY((n) + 0x9), STR_TINY((n) + 0xA), STR_TINY((n) + 0xB), \
+  STR_TINY((n) + 0xC), STR_TINY((n) + 0xD), STR_TINY((n) + 0xE), STR_TINY((n) + 0xF)
+
+// Node of the multi-pattern automaton, children of the node are stored in a sorted range of edges array.
+typedef struct {
+  wchar_t c;
+  size_t child;
+  size_t sibling;
+  size_t edges;
+  size_t edges_len;
+  size_t fail;
+  size_t depth;
+  size_t match;
+} str_matcher_node_t;
+
+typedef struct {
+  str_matcher_node_t *nodes;
+  size_t *edges;
+  size_t *lens;
+} str_matcher_t;
+
+// Node of the rope, leaves reference a range of a string, branches are kept balanced by height (as in AVL tree).
+typedef struct str_rope_node_s {
+  volatile long refs;
+  struct str_rope_node_s *left;
+  struct str_rope_node_s *right;
+  d4_str_t str;
+  size_t start;
+  size_t len;
+  size_t height;
+} str_rope_node_t;
+
+// Header of the shared string buffer, string data is placed right after it. Cached hash describes the data, every
+// path that modifies the data in place resets it (see str_buf_update). Buffers may be read from several threads at
+// once, so the hash is only accessed atomically.
+typedef struct {
+  volatile long refs;
+  volatile size_t hash;
+  size_t cap;
+  bool is_interned;
+} str_buf_t;
+
+// Single ASCII character strings are served from this table instead of the heap. Entries are laid out as static
+// shared buffers, so that they are copied by pointer and detached before they are modified, same as interned strings.
+typedef struct {
+  str_buf_t buf;
+  wchar_t data[2];
+} str_tiny_t;
+
+static str_tiny_t str_tiny_table[0x80] = {
+  STR_TINY_ROW(0x00), STR_TINY_ROW(0x10), STR_TINY_ROW(0x20), STR_TINY_ROW(0x30),
+  STR_TINY_ROW(0x40), STR_TINY_ROW(0x50), STR_TINY_ROW(0x60), STR_TINY_ROW(0x70)
+};
+
+static bool str_is_tiny (const wchar_t *data, size_t len) {
+  return len == 1 && (unsigned long) data[0] < 0x80;
+}
 
-d4_str_t d4_str_empty_val = {NULL, 0, false};
+static d4_str_t str_tiny (wchar_t c) {
+  return (d4_str_t) {str_tiny_table[c].data, 1, true, true};
+}
 
-int snwprintf (const wchar_t *fmt, ...) {
-  va_list args;
-  int result;
+#if defined(D4_OS_WINDOWS)
+  static SRWLOCK str_intern_lock = SRWLOCK_INIT;
+#else
+  static pthread_mutex_t str_intern_lock = PTHREAD_MUTEX_INITIALIZER;
+#endif
 
-  va_start(args, fmt);
-  result = vsnwprintf(fmt, args);
-  va_end(args);
+// Open addressing table of interned strings, interned strings are never deallocated.
+static d4_str_t *str_intern_table = NULL;
+static size_t str_intern_cap = 0;
+static d4_str_intern_stats_t str_intern_stats = {0, 0, 0};
 
-  return result;
+static str_buf_t *str_buf (wchar_t *data) {
+  return (str_buf_t *) (void *) data - 1;
 }
 
-int vsnwprintf (const wchar_t *fmt, va_list args) {
-  unsigned long long buf_size = 1024;
-  wchar_t *buffer = d4_safe_alloc(buf_size * sizeof(wchar_t));
-  int fmt_size = -1;
-  va_list args_copy;
-  int y;
-
-  while (buf_size <= INT_MAX) {
-    va_copy(args_copy, args);
-    y = vswprintf(buffer, (size_t) buf_size, fmt, args_copy);
-    va_end(args_copy);
+static wchar_t *str_buf_alloc (size_t len) {
+  str_buf_t *buf = d4_safe_alloc(sizeof(str_buf_t) + (len + 1) * sizeof(wchar_t));
+  buf->refs = 1;
+  buf->hash = 0;
+  buf->cap = len;
+  buf->is_interned = false;
+  return (wchar_t *) (void *) (buf + 1);
+}
 
-    if (y >= 0) {
-      fmt_size = y;
-      break;
-    }
+static void str_buf_free (wchar_t *data) {
+  d4_safe_free(str_buf(data));
+}
 
-    buf_size *= 2;
-    buffer = d4_safe_realloc(buffer, buf_size * sizeof(wchar_t));
-  }
+static wchar_t *str_buf_realloc (wchar_t *data, size_t len) {
+  str_buf_t *buf = d4_safe_realloc(str_buf(data), sizeof(str_buf_t) + (len + 1) * sizeof(wchar_t));
+  buf->cap = len;
+  return (wchar_t *) (void *) (buf + 1);
+}
 
-  d4_safe_free(buffer);
-  return fmt_size;
+static d4_str_t str_buf_str (wchar_t *data, size_t len) {
+  data[len] = L'\0';
+  return (d4_str_t) {data, len, false, true};
 }
 
-d4_str_t d4_str_alloc (const wchar_t *fmt, ...) {
-  wchar_t *d;
-  size_t l;
-  va_list args;
+static d4_str_t str_dup (const wchar_t *data, size_t len) {
+  wchar_t *d = str_buf_alloc(len);
+  wmemcpy(d, data, len);
+  return str_buf_str(d, len);
+}
 
-  if (fmt == NULL) {
-    return d4_str_empty_val;
-  }
+// Returns hash cached in header of shared string, zero if it wasn't computed yet or string is not shared.
+static size_t str_hash_cached (const d4_str_t self) {
+  return self.is_shared ? STR_HASH_LOAD(&str_buf(self.data)->hash) : 0;
+}
 
-  va_start(args, fmt);
-  l = (size_t) vsnwprintf(fmt, args);
-  d = d4_safe_alloc((l + 1) * sizeof(wchar_t));
-  vswprintf(d, l + 1, fmt, args);
-  va_end(args);
+static bool str_is_interned (const d4_str_t self) {
+  return self.is_shared && str_buf(self.data)->is_interned;
+}
 
-  return (d4_str_t) {d, l, false};
+// Checks whether string data is owned only by the caller, so that its buffer can be modified and reused.
+static bool str_is_unique (const d4_str_t self) {
+  return self.is_shared && !self.is_static && !str_buf(self.data)->is_interned && str_buf(self.data)->refs == 1;
 }
 
-d4_str_t d4_str_calloc (const wchar_t *self, size_t length) {
-  wchar_t *d;
+// Checks whether other string points into the buffer of shared string.
+static bool str_overlaps (const d4_str_t self, const d4_str_t other) {
+  uintptr_t begin = (uintptr_t) self.data;
+  uintptr_t end = begin + (str_buf(self.data)->cap + 1) * sizeof(wchar_t);
 
-  if (length == 0) {
-    return d4_str_empty_val;
-  }
+  return other.len != 0 && (uintptr_t) other.data >= begin && (uintptr_t) other.data < end;
+}
 
-  d = d4_safe_alloc((length + 1) * sizeof(wchar_t));
-  wmemcpy(d, self, length);
-  d[length] = L'\0';
-  return (d4_str_t) {d, length, false};
+// Finishes string which buffer was modified in place, cached hash is reset.
+static d4_str_t str_buf_update (wchar_t *data, size_t len) {
+  STR_HASH_STORE(&str_buf(data)->hash, 0);
+  return str_buf_str(data, len);
 }
 
-wchar_t *d4_str_at (d4_err_state_t *state, int line, int col, const d4_str_t self, int32_t index) {
-  if ((index >= 0 && (size_t) index >= self.len) || (index < 0 && index < -((int32_t) self.len))) {
+// Converts character index (negative counts from the end) into position, throws error if it's out of string bounds.
+static size_t str_at_index (d4_err_state_t *state, int line, int col, size_t len, int32_t index) {
+  if ((index >= 0 && (size_t) index >= len) || (index < 0 && index < -((int32_t) len))) {
     d4_str_t message = d4_str_alloc(L"index %" PRId32 L" out of string bounds", index);
     d4_error_assign_generic(state, line, col, message);
     d4_str_free(message);
     longjmp(state->buf_last->buf, state->id);
   }
 
-  return index < 0 ? &self.data[self.len + (size_t) index] : &self.data[index];
+  return index < 0 ? len + (size_t) index : (size_t) index;
 }
 
-d4_str_t d4_str_concat (const d4_str_t self, const d4_str_t other) {
-  size_t l = self.len + other.len;
-  wchar_t *d = d4_safe_alloc((l + 1) * sizeof(wchar_t));
-  wmemcpy(d, self.data, self.len);
-  wmemcpy(&d[self.len], other.data, other.len);
-  d[l] = L'\0';
-  return (d4_str_t) {d, l, false};
+// Returns null-terminated string with the same data. Only shared buffers are known to be terminated, data of other
+// strings (views or owned data of exact length) is copied without reading past its length.
+static d4_str_t str_terminated (const d4_str_t self) {
+  if (self.len == 0) {
+    return (d4_str_t) {L"", 0, true, false};
+  }
+
+  return self.is_shared ? self : d4_str_calloc(self.data, self.len);
 }
 
-bool d4_str_contains (const d4_str_t self, const d4_str_t search) {
-  if (self.len == search.len) {
-    return memcmp(self.data, search.data, self.len * sizeof(wchar_t)) >= 0;
-  }
+// Converts 8 decimal digits at once (SWAR), returns false if any of characters is not a decimal digit.
+static bool str_parse_chunk (const wchar_t *data, uint64_t *result) {
+  uint64_t val = 0;
 
-  if (self.len > 0 && self.len > search.len) {
-    for (size_t i = 0; i < self.len - search.len + 1; i++) {
-      if (memcmp(&self.data[i], search.data, search.len * sizeof(wchar_t)) >= 0) {
-        return true;
-      }
-    }
+  for (size_t i = 0; i < STR_PARSE_CHUNK_LEN; i++) {
+    unsigned long digit = (unsigned long) data[i] - (unsigned long) L'0';
+    if (digit > 9) return false;
+    val |= (uint64_t) digit << (i * 8);
   }
 
-  return false;
-}
-
-d4_str_t d4_str_copy (const d4_str_t self) {
-  wchar_t *d = d4_safe_alloc((self.len + 1) * sizeof(wchar_t));
-  wmemcpy(d, self.data, self.len);
-  d[self.len] = L'\0';
-  return (d4_str_t) {d, self.len, false};
-}
+  val = (val * 10) + (val >> 8);
+  val = (
+    ((val & 0x000000FF000000FF) * (100 + (UINT64_C(1000000) << 32))) +
+    (((val >> 16) & 0x000000FF000000FF) * (1 + (UINT64_C(10000) << 32)))
+  ) >> 32;
 
-bool d4_str_empty (const d4_str_t self) {
-  return self.len == 0;
+  *result = val;
+  return true;
 }
 
-bool d4_str_eq (const d4_str_t self, const d4_str_t rhs) {
-  return self.len == rhs.len && memcmp(self.data, rhs.data, self.len * sizeof(wchar_t)) == 0;
+static uint64_t str_parse_digit (wchar_t c) {
+  if (c >= L'0' && c <= L'9') return (uint64_t) (c - L'0');
+  if (c >= L'a' && c <= L'z') return (uint64_t) (c - L'a' + 10);
+  if (c >= L'A' && c <= L'Z') return (uint64_t) (c - L'A' + 10);
+  return 36;
 }
 
-d4_str_t d4_str_escape (const d4_str_t self) {
-  wchar_t *d = d4_safe_alloc((self.len + 1) * sizeof(wchar_t));
-  size_t l = 0;
+// Parses whole string as integer the same way wcstoull does, including leading whitespace, sign and radix prefix.
+// Returns magnitude and reports values above max (or above min for negative numbers) as out of range.
+static uint64_t str_parse_int (
+  d4_err_state_t *state,
+  int line,
+  int col,
+  const d4_str_t self,
+  unsigned char o1,
+  int32_t radix,
+  uint64_t max,
+  uint64_t min,
+  bool *negative
+) {
+  uint64_t base = o1 == 0 ? 10 : (uint64_t) radix;
+  uint64_t result = 0;
+  bool overflow = false;
+  size_t start;
+  size_t i = 0;
 
-  for (size_t i = 0; i < self.len; i++) {
-    wchar_t c = self.data[i];
+  if (o1 == 1 && (radix < 2 || radix > 36) && radix != 0) {
+    d4_str_t message = d4_str_alloc(L"radix %" PRId32 L" is invalid, must be >= 2 and <= 36, or 0", radix);
+    d4_error_assign_generic(state, line, col, message);
+    d4_str_free(message);
+    longjmp(state->buf_last->buf, state->id);
+  }
 
-    if (c == L'\f' || c == L'\n' || c == L'\r' || c == L'\t' || c == L'\v' || c == L'"') {
-      if (l + 3 > self.len) {
-        d = d4_safe_realloc(d, (l + 3) * sizeof(wchar_t));
-      }
+  while (i < self.len && (self.data[i] == L' ' || (self.data[i] >= L'\t' && self.data[i] <= L'\r'))) i++;
+  *negative = i < self.len && self.data[i] == L'-';
+  if (i < self.len && (self.data[i] == L'-' || self.data[i] == L'+')) i++;
+
+  if (
+    (base == 0 || base == 16) &&
+    i + 1 < self.len &&
+    self.data[i] == L'0' &&
+    (self.data[i + 1] == L'x' || self.data[i + 1] == L'X')
+  ) {
+    base = 16;
+    i += 2;
+  } else if (base == 0) {
+    base = i < self.len && self.data[i] == L'0' ? 8 : 10;
+  }
 
-      d[l++] = L'\\';
+  start = i;
 
-      if (c == L'\f') d[l++] = L'f';
-      else if (c == L'\n') d[l++] = L'n';
-      else if (c == L'\r') d[l++] = L'r';
-      else if (c == L'\t') d[l++] = L't';
-      else if (c == L'\v') d[l++] = L'v';
-      else if (c == L'"') d[l++] = L'"';
+  // At most 16 digits can be taken in chunks before result may overflow.
+  while (base == 10 && i + STR_PARSE_CHUNK_LEN <= self.len && i - start <= STR_PARSE_CHUNK_LEN) {
+    uint64_t chunk;
+    if (!str_parse_chunk(&self.data[i], &chunk)) break;
+    result = result * 100000000 + chunk;
+    i += STR_PARSE_CHUNK_LEN;
+  }
 
-      continue;
-    }
+  for (; i < self.len; i++) {
+    uint64_t digit = str_parse_digit(self.data[i]);
+    if (digit >= base) break;
 
-    if (l + 2 > self.len) {
-      d = d4_safe_realloc(d, (l + 2) * sizeof(wchar_t));
+    if (result > (UINT64_MAX - digit) / base) {
+      overflow = true;
+    } else {
+      result = result * base + digit;
     }
+  }
 
-    d[l++] = c;
+  if (overflow || result > (*negative ? min : max)) {
+    d4_str_t message = d4_str_alloc(L"value `%.*ls` out of range", (int) self.len, self.data);
+    d4_error_assign_generic(state, line, col, message);
+    d4_str_free(message);
+    longjmp(state->buf_last->buf, state->id);
+  } else if (i == start || i != self.len || (*negative && min == 0)) {
+    d4_str_t message = d4_str_alloc(L"value `%.*ls` has invalid syntax", (int) self.len, self.data);
+    d4_error_assign_generic(state, line, col, message);
+    d4_str_free(message);
+    longjmp(state->buf_last->buf, state->id);
   }
 
-  d[l] = L'\0';
-  return (d4_str_t) {d, l, false};
+  return result;
 }
 
-int32_t d4_str_find (const d4_str_t self, const d4_str_t search) {
-  if (search.len == 0) {
-    return 0;
+// Parses floating point number on fast path and falls back to libc for input it doesn't handle, e.g. hexadecimal
+// notation, infinity or values that are out of range.
+static double str_parse_float (d4_err_state_t *state, int line, int col, const d4_str_t self, bool is_f32) {
+  d4_str_t s;
+  wchar_t *e = NULL;
+  double r;
+
+  if (d4_float_parse(self.data, self.len, is_f32, &r)) {
+    return r;
   }
 
-  for (size_t i = 0; i < self.len; i++) {
-    if (memcmp(&self.data[i], search.data, search.len * sizeof(wchar_t)) == 0) {
-      return (int32_t) i;
-    }
+  s = str_terminated(self);
+  errno = 0;
+  r = is_f32 ? (double) wcstof(s.data, &e) : wcstod(s.data, &e);
+
+  if (errno == ERANGE || r < (is_f32 ? -(double) FLT_MAX : -DBL_MAX) || (is_f32 ? (double) FLT_MAX : DBL_MAX) < r) {
+    d4_str_t message = d4_str_alloc(L"value `%ls` out of range", s.data);
+    d4_error_assign_generic(state, line, col, message);
+    d4_str_free(message);
+  } else if (errno != 0 || e == s.data || *e != 0) {
+    d4_str_t message = d4_str_alloc(L"value `%ls` has invalid syntax", s.data);
+    d4_error_assign_generic(state, line, col, message);
+    d4_str_free(message);
   }
 
-  return -1;
+  if (s.data != self.data) d4_str_free(s);
+  if (state->id != -1) longjmp(state->buf_last->buf, state->id);
+  return r;
 }
 
-void d4_str_free (d4_str_t self) {
-  if (!self.is_static) d4_safe_free(self.data);
+static int64_t str_parse_signed (
+  d4_err_state_t *state,
+  int line,
+  int col,
+  const d4_str_t self,
+  unsigned char o1,
+  int32_t radix,
+  int64_t min,
+  int64_t max
+) {
+  bool negative;
+  uint64_t result = str_parse_int(state, line, col, self, o1, radix, (uint64_t) max, (uint64_t) -(min + 1) + 1, &negative);
+  return negative && result != 0 ? -(int64_t) (result - 1) - 1 : (int64_t) result;
 }
 
-bool d4_str_ge (const d4_str_t self, const d4_str_t rhs) {
-  return memcmp(self.data, rhs.data, (self.len > rhs.len ? self.len : rhs.len) * sizeof(wchar_t)) >= 0;
+static uint64_t str_parse_unsigned (
+  d4_err_state_t *state,
+  int line,
+  int col,
+  const d4_str_t self,
+  unsigned char o1,
+  int32_t radix,
+  uint64_t max
+) {
+  bool negative;
+  return str_parse_int(state, line, col, self, o1, radix, max, 0, &negative);
 }
 
-bool d4_str_gt (const d4_str_t self, const d4_str_t rhs) {
-  return memcmp(self.data, rhs.data, (self.len > rhs.len ? self.len : rhs.len) * sizeof(wchar_t)) > 0;
+// Compares strings stored in array that is sorted with qsort.
+static int str_qsort_cmp (const void *lhs, const void *rhs) {
+  return d4_str_cmp(*(const d4_str_t *) lhs, *(const d4_str_t *) rhs);
 }
 
-bool d4_str_le (const d4_str_t self, const d4_str_t rhs) {
-  return memcmp(self.data, rhs.data, (self.len > rhs.len ? self.len : rhs.len) * sizeof(wchar_t)) <= 0;
-}
+// Checks first and last characters of the needle before comparing the rest, needle should be at least 2 characters long.
+static const wchar_t *str_search_scalar (const wchar_t *h, size_t hl, const wchar_t *n, size_t nl, size_t i) {
+  for (; i + nl <= hl; i++) {
+    if (h[i] == n[0] && h[i + nl - 1] == n[nl - 1] && wmemcmp(&h[i + 1], &n[1], nl - 2) == 0) {
+      return &h[i];
+    }
+  }
 
-bool d4_str_lt (const d4_str_t self, const d4_str_t rhs) {
-  return memcmp(self.data, rhs.data, (self.len > rhs.len ? self.len : rhs.len) * sizeof(wchar_t)) < 0;
+  return NULL;
 }
 
-d4_str_t d4_str_quoted_escape (d4_str_t self) {
-  d4_str_t q = (d4_str_t) {L"\"", 1, true};
-  d4_str_t escaped = d4_str_escape(self);
-  d4_str_t left_result = d4_str_concat(q, escaped);
-  d4_str_t result = d4_str_concat(left_result, q);
+// Crochemore-Perrin Two-Way algorithm, linear in the worst case and doesn't allocate.
+static const wchar_t *str_search_two_way (const wchar_t *h, size_t hl, const wchar_t *n, size_t nl) {
+  size_t ip = (size_t) -1;
+  size_t jp = 0;
+  size_t k = 1;
+  size_t p = 1;
+  size_t ms;
+  size_t p0;
+  size_t mem = 0;
+  size_t mem0;
+
+  while (jp + k < nl) {
+    if (n[ip + k] == n[jp + k]) {
+      if (k == p) {
+        jp += p;
+        k = 1;
+      } else {
+        k++;
+      }
+    } else if (n[ip + k] > n[jp + k]) {
+      jp += k;
+      k = 1;
+      p = jp - ip;
+    } else {
+      ip = jp++;
+      k = p = 1;
+    }
+  }
 
-  d4_str_free(escaped);
-  d4_str_free(left_result);
+  ms = ip;
+  p0 = p;
+  ip = (size_t) -1;
+  jp = 0;
+  k = p = 1;
+
+  while (jp + k < nl) {
+    if (n[ip + k] == n[jp + k]) {
+      if (k == p) {
+        jp += p;
+        k = 1;
+      } else {
+        k++;
+      }
+    } else if (n[ip + k] < n[jp + k]) {
+      jp += k;
+      k = 1;
+      p = jp - ip;
+    } else {
+      ip = jp++;
+      k = p = 1;
+    }
+  }
 
-  return result;
-}
+  if (ip + 1 > ms + 1) {
+    ms = ip;
+  } else {
+    p = p0;
+  }
 
-d4_str_t d4_str_realloc (d4_str_t self, const d4_str_t rhs) {
-  if (self.len == 0) {
-    self.data = d4_safe_alloc((rhs.len + 1) * sizeof(wchar_t));
+  if (wmemcmp(n, &n[p], ms + 1) != 0) {
+    mem0 = 0;
+    p = (ms > nl - ms - 1 ? ms : nl - ms - 1) + 1;
   } else {
-    self.data = d4_safe_realloc(self.data, (rhs.len + 1) * sizeof(wchar_t));
+    mem0 = nl - p;
   }
 
-  wmemcpy(self.data, rhs.data, rhs.len);
-  self.data[rhs.len] = L'\0';
-  return (d4_str_t) {self.data, rhs.len, false};
-}
+  for (size_t i = 0; i + nl <= hl;) {
+    for (k = ms + 1 > mem ? ms + 1 : mem; k < nl && n[k] == h[i + k]; k++) {
+    }
 
-d4_arr_str_t d4_str_lines (const d4_str_t self, unsigned char o1, bool keepLineBreaks) {
-  bool k = o1 == 0 ? false : keepLineBreaks;
-  d4_str_t *result = NULL;
-  size_t len = 0;
-  size_t start = 0;
+    if (k < nl) {
+      i += k - ms;
+      mem = 0;
+      continue;
+    }
 
-  if (self.len != 0) {
-    return (d4_arr_str_t) {NULL, 0};
+    for (k = ms + 1; k > mem && n[k - 1] == h[i + k - 1]; k--) {
+    }
+
+    if (k <= mem) {
+      return &h[i];
+    }
+
+    i += p;
+    mem = mem0;
+  }
+
+  return NULL;
+}
+
+#if defined(STR_SEARCH_SSE2)
+  static unsigned str_search_ctz (unsigned mask) {
+    #if defined(_MSC_VER)
+      unsigned long result;
+      _BitScanForward(&result, mask);
+      return (unsigned) result;
+    #else
+      return (unsigned) __builtin_ctz(mask);
+    #endif
   }
 
-  for (size_t j = 0; j < self.len; j++) {
-    wchar_t c = self.data[j];
+  // Compares blocks against first and last characters of the needle, needle should be at least 2 characters long.
+  static const wchar_t *str_search_sse2 (const wchar_t *h, size_t hl, const wchar_t *n, size_t nl) {
+    const __m128i first = STR_SEARCH_SET1_128(n[0]);
+    const __m128i last = STR_SEARCH_SET1_128(n[nl - 1]);
+    size_t i = 0;
 
-    if (c == L'\r' || c == L'\n') {
-      size_t beforeLineBreak = j;
+    for (; i + nl - 1 + STR_SEARCH_LANES_128 <= hl; i += STR_SEARCH_LANES_128) {
+      const __m128i block_first = _mm_loadu_si128((const __m128i *) (const void *) &h[i]);
+      const __m128i block_last = _mm_loadu_si128((const __m128i *) (const void *) &h[i + nl - 1]);
+      __m128i eq = _mm_and_si128(STR_SEARCH_CMPEQ_128(first, block_first), STR_SEARCH_CMPEQ_128(last, block_last));
+      unsigned mask = (unsigned) _mm_movemask_epi8(eq);
 
-      if (c == L'\r' && j + 1 < self.len && self.data[j + 1] == L'\n') {
-        j++;
-      }
+      while (mask != 0) {
+        unsigned bit = str_search_ctz(mask);
+        size_t pos = i + bit / sizeof(wchar_t);
 
-      result = d4_safe_realloc(result, ++len * sizeof(d4_str_t));
-      result[len - 1] = d4_str_calloc(&self.data[start], (k ? j + 1 : beforeLineBreak) - start);
+        if (wmemcmp(&h[pos + 1], &n[1], nl - 2) == 0) {
+          return &h[pos];
+        }
 
-      start = j + 1;
+        mask &= ~(STR_SEARCH_LANE_MASK << bit);
+      }
     }
-  }
 
-  if (start != self.len) {
-    result = d4_safe_realloc(result, ++len * sizeof(d4_str_t));
-    result[len - 1] = d4_str_calloc(&self.data[start], self.len - start);
+    return str_search_scalar(h, hl, n, nl, i);
   }
+#endif
 
-  return (d4_arr_str_t) {result, len};
-}
+#if defined(STR_SEARCH_AVX2)
+  __attribute__((target("avx2")))
+  static const wchar_t *str_search_avx2 (const wchar_t *h, size_t hl, const wchar_t *n, size_t nl) {
+    const __m256i first = STR_SEARCH_SET1_256(n[0]);
+    const __m256i last = STR_SEARCH_SET1_256(n[nl - 1]);
+    size_t i = 0;
 
-d4_str_t d4_str_lower (const d4_str_t self) {
-  d4_str_t d = d4_str_copy(self);
+    for (; i + nl - 1 + STR_SEARCH_LANES_256 <= hl; i += STR_SEARCH_LANES_256) {
+      const __m256i block_first = _mm256_loadu_si256((const __m256i *) (const void *) &h[i]);
+      const __m256i block_last = _mm256_loadu_si256((const __m256i *) (const void *) &h[i + nl - 1]);
+      __m256i eq = _mm256_and_si256(STR_SEARCH_CMPEQ_256(first, block_first), STR_SEARCH_CMPEQ_256(last, block_last));
+      unsigned mask = (unsigned) _mm256_movemask_epi8(eq);
 
-  if (self.len == 0) {
-    return d;
-  }
+      while (mask != 0) {
+        unsigned bit = str_search_ctz(mask);
+        size_t pos = i + bit / sizeof(wchar_t);
+
+        if (wmemcmp(&h[pos + 1], &n[1], nl - 2) == 0) {
+          return &h[pos];
+        }
+
+        mask &= ~(STR_SEARCH_LANE_MASK << bit);
+      }
+    }
 
-  for (size_t i = 0; i < d.len; i++) {
-    d.data[i] = (wchar_t) tolower(d.data[i]);
+    return str_search_scalar(h, hl, n, nl, i);
+  }
+#endif
+
+// Finds first occurrence of non-empty needle in haystack, returns NULL if not found.
+static const wchar_t *str_search (const wchar_t *h, size_t hl, const wchar_t *n, size_t nl) {
+  if (nl > hl) {
+    return NULL;
+  } else if (nl == 1) {
+    return wmemchr(h, n[0], hl);
+  } else if (nl > STR_SEARCH_TWO_WAY_MIN) {
+    return str_search_two_way(h, hl, n, nl);
   }
 
-  return d;
+  #if defined(STR_SEARCH_AVX2)
+    if (__builtin_cpu_supports("avx2")) {
+      return str_search_avx2(h, hl, n, nl);
+    }
+  #endif
+
+  #if defined(STR_SEARCH_SSE2)
+    return str_search_sse2(h, hl, n, nl);
+  #else
+    return str_search_scalar(h, hl, n, nl, 0);
+  #endif
 }
 
-d4_str_t d4_str_lowerFirst (const d4_str_t self) {
-  d4_str_t d = d4_str_copy(self);
+// Finds position of the first mismatching character of two buffers, returns len if buffers are equal.
+static size_t str_mismatch (const wchar_t *a, const wchar_t *b, size_t len) {
+  size_t i = 0;
 
-  if (self.len == 0) {
-    return d;
-  }
+  #if defined(STR_SEARCH_SSE2)
+    for (; i + STR_SEARCH_LANES_128 <= len; i += STR_SEARCH_LANES_128) {
+      const __m128i block_a = _mm_loadu_si128((const __m128i *) (const void *) &a[i]);
+      const __m128i block_b = _mm_loadu_si128((const __m128i *) (const void *) &b[i]);
+      unsigned mask = (unsigned) _mm_movemask_epi8(STR_SEARCH_CMPEQ_128(block_a, block_b)) ^ 0xFFFFU;
 
-  d.data[0] = (wchar_t) tolower(d.data[0]);
-  return d;
+      if (mask != 0) {
+        return i + str_search_ctz(mask) / sizeof(wchar_t);
+      }
+    }
+  #endif
+
+  while (i < len && a[i] == b[i]) i++;
+  return i;
 }
 
-bool d4_str_not (const d4_str_t self) {
-  return self.len == 0;
+static bool str_escape_needed (wchar_t c) {
+  return (c >= L'\t' && c <= L'\r') || c == L'"';
 }
 
-d4_str_t d4_str_replace (const d4_str_t self, const d4_str_t search, const d4_str_t replacement, D4_UNUSED unsigned char o3, int32_t count) {
-  size_t l = 0;
-  wchar_t *d = NULL;
-  int32_t k = 0;
-  size_t j = 0;
-
-  if (search.len == 0 && replacement.len > 0) {
-    l = self.len + (count > 0 && (size_t) count <= self.len ? (size_t) count : self.len + 1) * replacement.len;
-    d = d4_safe_alloc((l + 1) * sizeof(wchar_t));
-    wmemcpy(d, replacement.data, replacement.len);
-    j = replacement.len;
-
-    for (size_t i = 0; i < self.len; i++) {
-      d[j++] = self.data[i];
-
-      if (count <= 0 || ++k < count) {
-        wmemcpy(&d[j], replacement.data, replacement.len);
-        j += replacement.len;
-      }
-    }
-  } else if (self.len == search.len && search.len > 0) {
-    if (memcmp(self.data, search.data, search.len * sizeof(wchar_t)) != 0) {
-      l = self.len;
-      d = d4_safe_alloc((l + 1) * sizeof(wchar_t));
-      wmemcpy(d, self.data, l);
-    } else if (replacement.len > 0) {
-      l = replacement.len;
-      d = d4_safe_alloc((l + 1) * sizeof(wchar_t));
-      wmemcpy(d, replacement.data, l);
-    }
-  } else if (self.len > search.len && search.len > 0 && replacement.len == 0) {
-    d = d4_safe_alloc((self.len + 1) * sizeof(wchar_t));
-
-    for (size_t i = 0; i < self.len; i++) {
-      if (
-        i <= self.len - search.len &&
-        memcmp(&self.data[i], search.data, search.len * sizeof(wchar_t)) == 0 &&
-        (count <= 0 || k++ < count)
-      ) {
-        i += search.len - 1;
-      } else {
-        d[l++] = self.data[i];
+// Finds position of the next character that needs escaping starting from position i, returns len if there is none.
+static size_t str_escape_find (const wchar_t *data, size_t len, size_t i) {
+  #if defined(STR_SEARCH_SSE2)
+    const __m128i quote = STR_SEARCH_SET1_128(L'"');
+    const __m128i lower = STR_SEARCH_SET1_128(L'\t' - 1);
+    const __m128i upper = STR_SEARCH_SET1_128(L'\r' + 1);
+
+    for (; i + STR_SEARCH_LANES_128 <= len; i += STR_SEARCH_LANES_128) {
+      const __m128i block = _mm_loadu_si128((const __m128i *) (const void *) &data[i]);
+      __m128i range = _mm_and_si128(STR_SEARCH_CMPGT_128(block, lower), STR_SEARCH_CMPGT_128(upper, block));
+      unsigned mask = (unsigned) _mm_movemask_epi8(_mm_or_si128(range, STR_SEARCH_CMPEQ_128(block, quote)));
+
+      if (mask != 0) {
+        return i + str_search_ctz(mask) / sizeof(wchar_t);
       }
     }
+  #endif
 
-    if (l == 0) {
-      d4_safe_free(d);
-      d = NULL;
-    } else if (l != self.len) {
-      d = d4_safe_realloc(d, (l + 1) * sizeof(wchar_t));
-    }
-  } else if (self.len > search.len && search.len > 0 && replacement.len > 0) {
-    l = self.len;
-    d = d4_safe_alloc((l + 1) * sizeof(wchar_t));
+  while (i < len && !str_escape_needed(data[i])) i++;
+  return i;
+}
 
-    for (size_t i = 0; i < self.len; i++) {
-      if (
-        i <= self.len - search.len &&
-        memcmp(&self.data[i], search.data, search.len * sizeof(wchar_t)) == 0 &&
-        (count <= 0 || k++ < count)
-      ) {
-        if (search.len < replacement.len) {
-          l += replacement.len - search.len;
+// Writes escaped string into buffer that should hold exactly `len` plus number of characters that need escaping.
+static void str_escape_write (wchar_t *d, const d4_str_t self) {
+  size_t k = 0;
 
-          if (l > self.len) {
-            d = d4_safe_realloc(d, (l + 1) * sizeof(wchar_t));
-          }
-        } else if (search.len > replacement.len) {
-          l -= search.len - replacement.len;
-        }
+  for (size_t i = 0; i < self.len;) {
+    size_t j = str_escape_find(self.data, self.len, i);
+    wchar_t c;
 
-        wmemcpy(&d[j], replacement.data, replacement.len);
-        j += replacement.len;
-        i += search.len - 1;
-      } else {
-        d[j++] = self.data[i];
-      }
+    if (j != i) {
+      wmemcpy(&d[k], &self.data[i], j - i);
+      k += j - i;
     }
 
-    d = d4_safe_realloc(d, (l + 1) * sizeof(wchar_t));
-  } else if (self.len > 0) {
-    l = self.len;
-    d = d4_safe_alloc((l + 1) * sizeof(wchar_t));
-    wmemcpy(d, self.data, l);
+    if (j == self.len) {
+      break;
+    }
+
+    c = self.data[j];
+    d[k++] = L'\\';
+    d[k++] = c == L'\f' ? L'f' : c == L'\n' ? L'n' : c == L'\r' ? L'r' : c == L'\t' ? L't' : c == L'\v' ? L'v' : c;
+    i = j + 1;
   }
+}
 
-  if (d != NULL) {
-    d[l] = '\0';
+static size_t str_escape_len (const d4_str_t self) {
+  size_t len = self.len;
+
+  for (size_t i = str_escape_find(self.data, self.len, 0); i < self.len; i = str_escape_find(self.data, self.len, i + 1)) {
+    len++;
   }
 
-  return (d4_str_t) {d, l, false};
+  return len;
 }
 
-d4_str_t d4_str_slice (const d4_str_t self, unsigned char o1, int32_t start, unsigned char o2, int32_t end) {
-  int32_t i = 0;
-  int32_t j = 0;
-  size_t l;
+// Maps characters into lowercase or uppercase, blocks of ASCII characters are mapped with SSE2 instructions.
+static void str_case_map (wchar_t *d, const wchar_t *data, size_t len, bool lower) {
+  size_t i = 0;
 
-  if (o1 != 0 && start < 0 && start >= -((int32_t) self.len)) {
-    i = (int32_t) ((size_t) start + self.len);
-  } else if (o1 != 0 && start >= 0) {
-    i = (int32_t) ((size_t) start > self.len ? self.len : (size_t) start);
-  }
+  #if defined(STR_SEARCH_SSE2)
+    const __m128i from = STR_SEARCH_SET1_128(lower ? L'A' - 1 : L'a' - 1);
+    const __m128i to = STR_SEARCH_SET1_128(lower ? L'Z' + 1 : L'z' + 1);
+    const __m128i flip = STR_SEARCH_SET1_128(0x20);
+    const __m128i non_ascii = STR_SEARCH_SET1_128(~0x7F);
+    const __m128i zero = _mm_setzero_si128();
 
-  if (o2 == 0 || (end >= 0 && (size_t) end > self.len)) {
-    j = (int32_t) self.len;
-  } else if (end < 0 && end >= -((int32_t) self.len)) {
-    j = (int32_t) ((size_t) end + self.len);
-  } else if (end >= 0) {
-    j = (int32_t) end;
-  }
+    for (; i + STR_SEARCH_LANES_128 <= len; i += STR_SEARCH_LANES_128) {
+      const __m128i block = _mm_loadu_si128((const __m128i *) (const void *) &data[i]);
+      __m128i range;
 
-  if (i >= j || (size_t) i >= self.len) {
-    return d4_str_empty_val;
+      if (_mm_movemask_epi8(STR_SEARCH_CMPEQ_128(_mm_and_si128(block, non_ascii), zero)) != 0xFFFF) {
+        for (size_t j = i; j < i + STR_SEARCH_LANES_128; j++) {
+          d[j] = lower ? d4_rune_lower(data[j]) : d4_rune_upper(data[j]);
+        }
+
+        continue;
+      }
+
+      range = _mm_and_si128(STR_SEARCH_CMPGT_128(block, from), STR_SEARCH_CMPGT_128(to, block));
+      _mm_storeu_si128((__m128i *) (void *) &d[i], _mm_xor_si128(block, _mm_and_si128(range, flip)));
+    }
+  #endif
+
+  for (; i < len; i++) {
+    d[i] = lower ? d4_rune_lower(data[i]) : d4_rune_upper(data[i]);
   }
+}
 
-  l = (size_t) (j - i);
-  return d4_str_calloc(&self.data[i], l);
+// Returns properties checked by classification function of rune module, zero for any other predicate.
+static unsigned char str_pred_props (d4_str_pred_cb predicate) {
+  if (predicate == d4_rune_isDigit) return D4_RUNE_DIGIT;
+  if (predicate == d4_rune_isLetter) return D4_RUNE_LETTER;
+  if (predicate == d4_rune_isLetterOrDigit) return D4_RUNE_LETTER | D4_RUNE_DIGIT;
+  if (predicate == d4_rune_isLower) return D4_RUNE_LOWER;
+  if (predicate == d4_rune_isUpper) return D4_RUNE_UPPER;
+  if (predicate == d4_rune_isWhitespace) return D4_RUNE_WHITESPACE;
+  return 0;
 }
 
-d4_arr_str_t d4_str_split (const d4_str_t self, D4_UNUSED unsigned char o1, const d4_str_t delimiter) {
-  d4_str_t *r = NULL;
-  size_t l = 0;
+#if defined(STR_SEARCH_SSE2)
+  static __m128i str_props_range (__m128i block, wchar_t from, wchar_t to) {
+    return _mm_and_si128(
+      STR_SEARCH_CMPGT_128(block, STR_SEARCH_SET1_128(from - 1)),
+      STR_SEARCH_CMPGT_128(STR_SEARCH_SET1_128(to + 1), block)
+    );
+  }
 
-  if (self.len > 0 && delimiter.len == 0) {
-    l = self.len;
-    r = d4_safe_alloc(l * sizeof(d4_str_t));
+  // Returns lanes of block that have any of the properties, block is expected to contain only ASCII characters.
+  static __m128i str_props_block (__m128i block, unsigned char props) {
+    __m128i result = _mm_setzero_si128();
 
-    for (size_t i = 0; i < l; i++) {
-      r[i] = d4_str_calloc(&self.data[i], 1);
+    if ((props & D4_RUNE_DIGIT) != 0) {
+      result = _mm_or_si128(result, str_props_range(block, L'0', L'9'));
     }
-  } else if (self.len < delimiter.len) {
-    r = d4_safe_realloc(r, ++l * sizeof(d4_str_t));
-    r[0] = d4_str_calloc(self.data, self.len);
-  } else if (delimiter.len > 0) {
-    size_t i = 0;
 
-    for (size_t j = 0; j <= self.len - delimiter.len; j++) {
-      if (memcmp(&self.data[j], delimiter.data, delimiter.len * sizeof(wchar_t)) == 0) {
-        r = d4_safe_realloc(r, ++l * sizeof(d4_str_t));
-        r[l - 1] = d4_str_calloc(&self.data[i], j - i);
-        j += delimiter.len;
-        i = j;
-      }
+    if ((props & (D4_RUNE_LETTER | D4_RUNE_UPPER)) != 0) {
+      result = _mm_or_si128(result, str_props_range(block, L'A', L'Z'));
+    }
+
+    if ((props & (D4_RUNE_LETTER | D4_RUNE_LOWER)) != 0) {
+      result = _mm_or_si128(result, str_props_range(block, L'a', L'z'));
+    }
+
+    if ((props & D4_RUNE_WHITESPACE) != 0) {
+      result = _mm_or_si128(result, str_props_range(block, L'\t', L'\r'));
+      result = _mm_or_si128(result, STR_SEARCH_CMPEQ_128(block, STR_SEARCH_SET1_128(L' ')));
     }
 
-    r = d4_safe_realloc(r, ++l * sizeof(d4_str_t));
-    r[l - 1] = d4_str_calloc(&self.data[i], self.len - i);
+    return result;
   }
 
-  return (d4_arr_str_t) {r, l};
-}
+  static bool str_props_ascii (__m128i block) {
+    const __m128i non_ascii = _mm_and_si128(block, STR_SEARCH_SET1_128(~0x7F));
+    return _mm_movemask_epi8(STR_SEARCH_CMPEQ_128(non_ascii, _mm_setzero_si128())) == 0xFFFF;
+  }
+#endif
 
-double d4_str_toFloat (d4_err_state_t *state, int line, int col, const d4_str_t self) {
-  wchar_t *e = NULL;
-  double r;
+// Counts characters that have any of the properties.
+static size_t str_props_count (const wchar_t *data, size_t len, unsigned char props) {
+  size_t result = 0;
+  size_t i = 0;
 
-  errno = 0;
-  r = wcstod(self.data, &e);
+  #if defined(STR_SEARCH_SSE2)
+    for (; i + STR_SEARCH_LANES_128 <= len; i += STR_SEARCH_LANES_128) {
+      const __m128i block = _mm_loadu_si128((const __m128i *) (const void *) &data[i]);
+      size_t bits = 0;
+      unsigned mask;
 
-  if (errno == ERANGE || r < -DBL_MAX || DBL_MAX < r) {
-    d4_str_t message = d4_str_alloc(L"value `%ls` out of range", self.data);
-    d4_error_assign_generic(state, line, col, message);
-    d4_str_free(message);
-  } else if (errno != 0 || e == self.data || *e != 0) {
-    d4_str_t message = d4_str_alloc(L"value `%ls` has invalid syntax", self.data);
-    d4_error_assign_generic(state, line, col, message);
-    d4_str_free(message);
-  }
+      if (!str_props_ascii(block)) {
+        for (size_t j = i; j < i + STR_SEARCH_LANES_128; j++) {
+          if ((d4_rune_props(data[j]) & props) != 0) result++;
+        }
 
-  if (state->id != -1) longjmp(state->buf_last->buf, state->id);
-  return r;
-}
+        continue;
+      }
 
-float d4_str_toF32 (d4_err_state_t *state, int line, int col, const d4_str_t self) {
-  wchar_t *e = NULL;
-  float r;
+      for (mask = (unsigned) _mm_movemask_epi8(str_props_block(block, props)); mask != 0; mask &= mask - 1) {
+        bits++;
+      }
 
-  errno = 0;
-  r = wcstof(self.data, &e);
+      result += bits / sizeof(wchar_t);
+    }
+  #endif
 
-  if (errno == ERANGE || r < -FLT_MAX || FLT_MAX < r) {
-    d4_str_t message = d4_str_alloc(L"value `%ls` out of range", self.data);
-    d4_error_assign_generic(state, line, col, message);
-    d4_str_free(message);
-  } else if (errno != 0 || e == self.data || *e != 0) {
-    d4_str_t message = d4_str_alloc(L"value `%ls` has invalid syntax", self.data);
-    d4_error_assign_generic(state, line, col, message);
-    d4_str_free(message);
+  for (; i < len; i++) {
+    if ((d4_rune_props(data[i]) & props) != 0) result++;
   }
 
-  if (state->id != -1) longjmp(state->buf_last->buf, state->id);
-  return r;
+  return result;
 }
 
-double d4_str_toF64 (d4_err_state_t *state, int line, int col, const d4_str_t self) {
-  wchar_t *e = NULL;
-  double r;
+// Finds position of the next character starting from position i that has none of the properties, returns len if there is none.
+static size_t str_props_skip (const wchar_t *data, size_t len, size_t i, unsigned char props) {
+  #if defined(STR_SEARCH_SSE2)
+    for (; i + STR_SEARCH_LANES_128 <= len; i += STR_SEARCH_LANES_128) {
+      const __m128i block = _mm_loadu_si128((const __m128i *) (const void *) &data[i]);
+      unsigned mask;
 
-  errno = 0;
-  r = wcstod(self.data, &e);
+      if (!str_props_ascii(block)) {
+        break;
+      }
+
+      mask = (unsigned) _mm_movemask_epi8(str_props_block(block, props)) ^ 0xFFFFU;
+
+      if (mask != 0) {
+        return i + str_search_ctz(mask) / sizeof(wchar_t);
+      }
+    }
+  #endif
+
+  while (i < len && (d4_rune_props(data[i]) & props) != 0) i++;
+  return i;
+}
+
+// Finds position of the first character of two buffers that differs after case folding, returns len if there is none.
+static size_t str_mismatch_fold (const wchar_t *a, const wchar_t *b, size_t len) {
+  size_t i = 0;
+
+  #if defined(STR_SEARCH_SSE2)
+    const __m128i flip = STR_SEARCH_SET1_128(0x20);
+
+    for (; i + STR_SEARCH_LANES_128 <= len; i += STR_SEARCH_LANES_128) {
+      __m128i block_a = _mm_loadu_si128((const __m128i *) (const void *) &a[i]);
+      __m128i block_b = _mm_loadu_si128((const __m128i *) (const void *) &b[i]);
+      unsigned mask;
+
+      if (!str_props_ascii(_mm_or_si128(block_a, block_b))) {
+        for (size_t j = i; j < i + STR_SEARCH_LANES_128; j++) {
+          if (d4_rune_fold(a[j]) != d4_rune_fold(b[j])) return j;
+        }
+
+        continue;
+      }
+
+      block_a = _mm_or_si128(block_a, _mm_and_si128(str_props_range(block_a, L'A', L'Z'), flip));
+      block_b = _mm_or_si128(block_b, _mm_and_si128(str_props_range(block_b, L'A', L'Z'), flip));
+      mask = (unsigned) _mm_movemask_epi8(STR_SEARCH_CMPEQ_128(block_a, block_b)) ^ 0xFFFFU;
+
+      if (mask != 0) {
+        return i + str_search_ctz(mask) / sizeof(wchar_t);
+      }
+    }
+  #endif
+
+  while (i < len && d4_rune_fold(a[i]) == d4_rune_fold(b[i])) i++;
+  return i;
+}
+
+// Finds position of the needle in the haystack ignoring case, needle should not be empty or longer than haystack.
+static const wchar_t *str_search_fold (const wchar_t *h, size_t hl, const wchar_t *n, size_t nl) {
+  wchar_t first = d4_rune_fold(n[0]);
+  size_t i = 0;
+
+  #if defined(STR_SEARCH_SSE2)
+    if ((unsigned long) first < 0x80) {
+      const __m128i lower = STR_SEARCH_SET1_128(first);
+      const __m128i upper = STR_SEARCH_SET1_128(first >= L'a' && first <= L'z' ? first - 0x20 : first);
+
+      for (; i + nl - 1 + STR_SEARCH_LANES_128 <= hl; i += STR_SEARCH_LANES_128) {
+        const __m128i block = _mm_loadu_si128((const __m128i *) (const void *) &h[i]);
+        unsigned mask = (unsigned) _mm_movemask_epi8(_mm_or_si128(STR_SEARCH_CMPEQ_128(block, lower), STR_SEARCH_CMPEQ_128(block, upper)));
+
+        // Non-ASCII characters like Kelvin sign may fold into ASCII character, every position of such block is checked.
+        if (!str_props_ascii(block)) mask = 0xFFFFU;
+
+        while (mask != 0) {
+          unsigned bit = str_search_ctz(mask);
+          size_t pos = i + bit / sizeof(wchar_t);
+
+          if (d4_rune_fold(h[pos]) == first && str_mismatch_fold(&h[pos + 1], &n[1], nl - 1) == nl - 1) {
+            return &h[pos];
+          }
+
+          mask &= ~(STR_SEARCH_LANE_MASK << bit);
+        }
+      }
+    }
+  #endif
+
+  for (; i + nl <= hl; i++) {
+    if (d4_rune_fold(h[i]) == first && str_mismatch_fold(&h[i + 1], &n[1], nl - 1) == nl - 1) {
+      return &h[i];
+    }
+  }
+
+  return NULL;
+}
+
+static void str_searcher_shift (size_t *shift, const d4_str_t needle) {
+  for (size_t i = 0; i < STR_SEARCHER_SHIFT_LEN; i++) {
+    shift[i] = needle.len;
+  }
+
+  for (size_t i = 0; i + 1 < needle.len; i++) {
+    shift[(size_t) needle.data[i] & (STR_SEARCHER_SHIFT_LEN - 1)] = needle.len - 1 - i;
+  }
+}
+
+// Boyer-Moore-Horspool with shift table, falls back to regular search for needles without one. Needle should be non-empty.
+static const wchar_t *str_searcher_search (const d4_str_searcher_t self, const wchar_t *h, size_t hl) {
+  const wchar_t *n = self.needle.data;
+  size_t nl = self.needle.len;
+
+  if (self.shift == NULL) {
+    return str_search(h, hl, n, nl);
+  }
+
+  for (size_t i = 0; i + nl <= hl;) {
+    wchar_t c = h[i + nl - 1];
+
+    if (c == n[nl - 1] && wmemcmp(&h[i], n, nl - 1) == 0) {
+      return &h[i];
+    }
+
+    i += self.shift[(size_t) c & (STR_SEARCHER_SHIFT_LEN - 1)];
+  }
+
+  return NULL;
+}
+
+static size_t str_matcher_child (const str_matcher_t *m, size_t state, wchar_t c) {
+  size_t lo = m->nodes[state].edges;
+  size_t hi = lo + m->nodes[state].edges_len;
+
+  while (lo < hi) {
+    size_t mid = lo + (hi - lo) / 2;
+    wchar_t mid_c = m->nodes[m->edges[mid]].c;
+
+    if (mid_c == c) {
+      return m->edges[mid];
+    } else if (mid_c < c) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+
+  return 0;
+}
+
+static size_t str_matcher_next (const str_matcher_t *m, size_t state, wchar_t c) {
+  while (true) {
+    size_t next = str_matcher_child(m, state, c);
+    if (next != 0 || state == 0) return next;
+    state = m->nodes[state].fail;
+  }
+}
+
+// Finds leftmost-longest match starting from position `*from` and moves `*from` past it.
+static bool str_matcher_search (const str_matcher_t *m, const d4_str_t haystack, size_t *from, d4_str_match_t *result) {
+  size_t state = 0;
+  bool found = false;
+
+  for (size_t i = *from; i < haystack.len; i++) {
+    state = str_matcher_next(m, state, haystack.data[i]);
+
+    if (m->nodes[state].match != 0) {
+      size_t pattern = m->nodes[state].match - 1;
+      size_t start = i + 1 - m->lens[pattern];
+
+      if (!found || start <= (size_t) result->start) {
+        *result = (d4_str_match_t) {pattern, (int32_t) start, (int32_t) m->lens[pattern]};
+        found = true;
+      }
+    }
+
+    if (found && i + 1 - m->nodes[state].depth > (size_t) result->start) {
+      break;
+    }
+  }
+
+  if (found) {
+    *from = (size_t) (result->start + result->len);
+  }
+
+  return found;
+}
+
+static str_rope_node_t *str_rope_retain (str_rope_node_t *node) {
+  if (node != NULL) STR_REFS_INCREMENT(&node->refs);
+  return node;
+}
+
+static void str_rope_release (str_rope_node_t *node) {
+  while (node != NULL && STR_REFS_DECREMENT(&node->refs) == 0) {
+    str_rope_node_t *right = node->right;
+
+    str_rope_release(node->left);
+    d4_str_free(node->str);
+    d4_safe_free(node);
+    node = right;
+  }
+}
+
+static size_t str_rope_height (const str_rope_node_t *node) {
+  return node == NULL ? 0 : node->height;
+}
+
+// Creates leaf taking ownership of the string.
+static str_rope_node_t *str_rope_leaf (d4_str_t str, size_t start, size_t len) {
+  str_rope_node_t *node = d4_safe_alloc(sizeof(str_rope_node_t));
+  node->refs = 1;
+  node->left = NULL;
+  node->right = NULL;
+  node->str = str;
+  node->start = start;
+  node->len = len;
+  node->height = 1;
+  return node;
+}
+
+// Creates branch taking ownership of both subtrees, heights of subtrees should differ by at most one.
+static str_rope_node_t *str_rope_branch (str_rope_node_t *left, str_rope_node_t *right) {
+  str_rope_node_t *node = d4_safe_alloc(sizeof(str_rope_node_t));
+  node->refs = 1;
+  node->left = left;
+  node->right = right;
+  node->str = d4_str_empty_val;
+  node->start = 0;
+  node->len = left->len + right->len;
+  node->height = (left->height > right->height ? left->height : right->height) + 1;
+  return node;
+}
+
+// Creates branch from subtrees which heights differ by at most two, rotating them into balance when needed.
+static str_rope_node_t *str_rope_balance (str_rope_node_t *left, str_rope_node_t *right) {
+  str_rope_node_t *result;
+
+  if (left->height > right->height + 1) {
+    if (str_rope_height(left->left) >= str_rope_height(left->right)) {
+      result = str_rope_branch(str_rope_retain(left->left), str_rope_branch(str_rope_retain(left->right), right));
+    } else {
+      result = str_rope_branch(
+        str_rope_branch(str_rope_retain(left->left), str_rope_retain(left->right->left)),
+        str_rope_branch(str_rope_retain(left->right->right), right)
+      );
+    }
+
+    str_rope_release(left);
+    return result;
+  } else if (right->height > left->height + 1) {
+    if (str_rope_height(right->right) >= str_rope_height(right->left)) {
+      result = str_rope_branch(str_rope_branch(left, str_rope_retain(right->left)), str_rope_retain(right->right));
+    } else {
+      result = str_rope_branch(
+        str_rope_branch(left, str_rope_retain(right->left->left)),
+        str_rope_branch(str_rope_retain(right->left->right), str_rope_retain(right->right))
+      );
+    }
+
+    str_rope_release(right);
+    return result;
+  }
+
+  return str_rope_branch(left, right);
+}
+
+// Joins two ropes taking ownership of both, adjacent small leaves are merged to keep the tree shallow.
+static str_rope_node_t *str_rope_join (str_rope_node_t *left, str_rope_node_t *right) {
+  str_rope_node_t *result;
+
+  if (left == NULL) {
+    return right;
+  } else if (right == NULL) {
+    return left;
+  } else if (left->height == 1 && right->height == 1 && left->len + right->len <= STR_ROPE_LEAF_LEN) {
+    wchar_t *d = str_buf_alloc(left->len + right->len);
+
+    wmemcpy(d, &left->str.data[left->start], left->len);
+    wmemcpy(&d[left->len], &right->str.data[right->start], right->len);
+    result = str_rope_leaf(str_buf_str(d, left->len + right->len), 0, left->len + right->len);
+    str_rope_release(left);
+    str_rope_release(right);
+    return result;
+  } else if (left->height > right->height + 1) {
+    result = str_rope_balance(str_rope_retain(left->left), str_rope_join(str_rope_retain(left->right), right));
+    str_rope_release(left);
+    return result;
+  } else if (right->height > left->height + 1) {
+    result = str_rope_balance(str_rope_join(left, str_rope_retain(right->left)), str_rope_retain(right->right));
+    str_rope_release(right);
+    return result;
+  }
+
+  return str_rope_branch(left, right);
+}
+
+// Splits rope at position into two ropes that share nodes and strings of the original one.
+static void str_rope_split (str_rope_node_t *node, size_t index, str_rope_node_t **left, str_rope_node_t **right) {
+  str_rope_node_t *rest;
+
+  if (index == 0) {
+    *left = NULL;
+    *right = str_rope_retain(node);
+  } else if (index >= node->len) {
+    *left = str_rope_retain(node);
+    *right = NULL;
+  } else if (node->height == 1) {
+    *left = str_rope_leaf(d4_str_copy(node->str), node->start, index);
+    *right = str_rope_leaf(d4_str_copy(node->str), node->start + index, node->len - index);
+  } else if (index <= node->left->len) {
+    str_rope_split(node->left, index, left, &rest);
+    *right = str_rope_join(rest, str_rope_retain(node->right));
+  } else {
+    str_rope_split(node->right, index - node->left->len, &rest, right);
+    *left = str_rope_join(str_rope_retain(node->left), rest);
+  }
+}
+
+// Finds leaf that contains character at position, position is updated to be relative to the leaf.
+static const str_rope_node_t *str_rope_find (const str_rope_node_t *node, size_t *index) {
+  while (node->height > 1) {
+    if (*index < node->left->len) {
+      node = node->left;
+    } else {
+      *index -= node->left->len;
+      node = node->right;
+    }
+  }
+
+  return node;
+}
+
+// Resolves optional start and end positions of a slice, negative positions are counted from the end.
+static bool str_slice_range (size_t len, unsigned char o1, int32_t start, unsigned char o2, int32_t end, size_t *from, size_t *to) {
+  int32_t i = 0;
+  int32_t j = 0;
+
+  if (o1 != 0 && start < 0 && start >= -((int32_t) len)) {
+    i = (int32_t) ((size_t) start + len);
+  } else if (o1 != 0 && start >= 0) {
+    i = (int32_t) ((size_t) start > len ? len : (size_t) start);
+  }
+
+  if (o2 == 0 || (end >= 0 && (size_t) end > len)) {
+    j = (int32_t) len;
+  } else if (end < 0 && end >= -((int32_t) len)) {
+    j = (int32_t) ((size_t) end + len);
+  } else if (end >= 0) {
+    j = (int32_t) end;
+  }
+
+  if (i >= j || (size_t) i >= len) {
+    return false;
+  }
+
+  *from = (size_t) i;
+  *to = (size_t) j;
+  return true;
+}
+
+static void str_builder_reserve (d4_str_builder_t *self, size_t len) {
+  size_t cap;
+
+  if (self->len + len <= self->cap) {
+    return;
+  }
+
+  cap = self->cap < STR_BUILDER_MIN_CAP ? STR_BUILDER_MIN_CAP : self->cap * 2;
+  if (cap < self->len + len) cap = self->len + len;
+
+  self->data = self->data == NULL ? str_buf_alloc(cap) : str_buf_realloc(self->data, cap);
+  self->cap = cap;
+}
+
+static void str_builder_append (d4_str_builder_t *self, const wchar_t *data, size_t len) {
+  if (len == 0) return;
+
+  str_builder_reserve(self, len);
+  wmemcpy(&self->data[self->len], data, len);
+  self->len += len;
+}
+
+static void str_builder_append_int (d4_str_builder_t *self, uint64_t num, bool negative) {
+  str_builder_reserve(self, D4_INT_BUF_LEN);
+  self->len += d4_int_write(&self->data[self->len], num, negative);
+}
+
+// Formats in one pass straight into string builder. Returns false if format contains specifiers that should be handled
+// by libc, string builder is left in unspecified state in this case.
+static bool str_format (d4_str_builder_t *self, const wchar_t *fmt, va_list args) {
+  const wchar_t *it = fmt;
+
+  while (*it != L'\0') {
+    const wchar_t *start = it;
+    int precision = -1;
+    int length = STR_FORMAT_LENGTH_NONE;
+
+    while (*it != L'\0' && *it != L'%') it++;
+    str_builder_append(self, start, (size_t) (it - start));
+    if (*it == L'\0') break;
+
+    if (*++it == L'%') {
+      d4_str_builder_appendWchar(self, *it++);
+      continue;
+    }
+
+    if (it[0] == L'.' && it[1] == L'*') {
+      precision = va_arg(args, int);
+      it += 2;
+    }
+
+    if (it[0] == L'h' && it[1] == L'h') {
+      length = STR_FORMAT_LENGTH_HH;
+      it += 2;
+    } else if (it[0] == L'h') {
+      length = STR_FORMAT_LENGTH_H;
+      it++;
+    } else if (it[0] == L'l' && it[1] == L'l') {
+      length = STR_FORMAT_LENGTH_LL;
+      it += 2;
+    } else if (it[0] == L'l') {
+      length = STR_FORMAT_LENGTH_L;
+      it++;
+    } else if (it[0] == L'z') {
+      length = STR_FORMAT_LENGTH_Z;
+      it++;
+    }
+
+    if (*it == L's' && length == STR_FORMAT_LENGTH_L) {
+      const wchar_t *arg = va_arg(args, const wchar_t *);
+      size_t l = 0;
+
+      // Null is formatted the way glibc formats it, "(null)" unless precision is too short to fit it.
+      if (arg == NULL) {
+        arg = precision < 0 || precision >= 6 ? L"(null)" : L"";
+      }
+
+      while ((precision < 0 || l < (size_t) precision) && arg[l] != L'\0') l++;
+      str_builder_append(self, arg, l);
+    } else if ((*it == L'd' || *it == L'i') && precision < 0) {
+      long long arg;
+
+      if (length == STR_FORMAT_LENGTH_LL) {
+        arg = va_arg(args, long long);
+      } else if (length == STR_FORMAT_LENGTH_L) {
+        arg = va_arg(args, long);
+      } else if (length == STR_FORMAT_LENGTH_Z) {
+        arg = va_arg(args, ptrdiff_t);
+      } else if (length == STR_FORMAT_LENGTH_H) {
+        arg = (short) va_arg(args, int);
+      } else if (length == STR_FORMAT_LENGTH_HH) {
+        arg = (signed char) va_arg(args, int);
+      } else {
+        arg = va_arg(args, int);
+      }
+
+      str_builder_append_int(self, arg < 0 ? 0 - (unsigned long long) arg : (unsigned long long) arg, arg < 0);
+    } else if (*it == L'u' && precision < 0) {
+      unsigned long long arg;
+
+      if (length == STR_FORMAT_LENGTH_LL) {
+        arg = va_arg(args, unsigned long long);
+      } else if (length == STR_FORMAT_LENGTH_L) {
+        arg = va_arg(args, unsigned long);
+      } else if (length == STR_FORMAT_LENGTH_Z) {
+        arg = va_arg(args, size_t);
+      } else if (length == STR_FORMAT_LENGTH_H) {
+        arg = (unsigned short) va_arg(args, unsigned int);
+      } else if (length == STR_FORMAT_LENGTH_HH) {
+        arg = (unsigned char) va_arg(args, unsigned int);
+      } else {
+        arg = va_arg(args, unsigned int);
+      }
+
+      str_builder_append_int(self, arg, false);
+    } else if (*it == L'f' && (length == STR_FORMAT_LENGTH_NONE || length == STR_FORMAT_LENGTH_L)) {
+      char buf[STR_FORMAT_FLOAT_BUF_LEN];
+      int l = snprintf(buf, sizeof(buf), "%.*f", precision < 0 ? 6 : precision, va_arg(args, double));
+
+      if (l < 0 || (size_t) l >= sizeof(buf)) {
+        return false;
+      }
+
+      str_builder_reserve(self, (size_t) l);
+
+      for (int i = 0; i < l; i++) {
+        self->data[self->len++] = (wchar_t) buf[i];
+      }
+    } else {
+      return false;
+    }
+
+    it++;
+  }
+
+  return true;
+}
+
+int snwprintf (const wchar_t *fmt, ...) {
+  va_list args;
+  int result;
+
+  va_start(args, fmt);
+  result = vsnwprintf(fmt, args);
+  va_end(args);
+
+  return result;
+}
+
+int vsnwprintf (const wchar_t *fmt, va_list args) {
+  d4_str_builder_t builder = d4_str_builder_alloc(0);
+  unsigned long long buf_size = 1024;
+  wchar_t *buffer;
+  int fmt_size = -1;
+  va_list args_copy;
+  int y;
+
+  va_copy(args_copy, args);
+
+  if (str_format(&builder, fmt, args_copy) && builder.len <= INT_MAX) {
+    fmt_size = (int) builder.len;
+    va_end(args_copy);
+    d4_str_builder_free(builder);
+    return fmt_size;
+  }
+
+  va_end(args_copy);
+  d4_str_builder_free(builder);
+  buffer = d4_safe_alloc(buf_size * sizeof(wchar_t));
+
+  while (buf_size <= INT_MAX) {
+    va_copy(args_copy, args);
+    y = vswprintf(buffer, (size_t) buf_size, fmt, args_copy);
+    va_end(args_copy);
+
+    if (y >= 0) {
+      fmt_size = y;
+      break;
+    }
+
+    buf_size *= 2;
+    buffer = d4_safe_realloc(buffer, buf_size * sizeof(wchar_t));
+  }
+
+  d4_safe_free(buffer);
+  return fmt_size;
+}
+
+d4_arr_str_t *d4_arr_str_sortAsc (d4_arr_str_t *self) {
+  if (self->len > 1) qsort(self->data, self->len, sizeof(d4_str_t), str_qsort_cmp);
+  return self;
+}
+
+d4_str_t d4_str_alloc (const wchar_t *fmt, ...) {
+  d4_str_builder_t builder = d4_str_builder_alloc(0);
+  wchar_t buf[STR_ALLOC_BUF_LEN];
+  wchar_t *d;
+  int y;
+  size_t l;
+  va_list args;
+  va_list args_copy;
+
+  if (fmt == NULL) {
+    return d4_str_empty_val;
+  }
+
+  va_start(args, fmt);
+  va_copy(args_copy, args);
+
+  if (str_format(&builder, fmt, args_copy)) {
+    va_end(args_copy);
+    va_end(args);
+
+    if (str_is_tiny(builder.data, builder.len)) {
+      d4_str_t result = str_tiny(builder.data[0]);
+      d4_str_builder_free(builder);
+      return result;
+    }
+
+    return d4_str_builder_finish(&builder);
+  }
+
+  va_end(args_copy);
+  d4_str_builder_free(builder);
+
+  va_copy(args_copy, args);
+  y = vswprintf(buf, STR_ALLOC_BUF_LEN, fmt, args_copy);
+  va_end(args_copy);
+
+  if (y >= 0) {
+    va_end(args);
+    return d4_str_calloc(buf, (size_t) y);
+  }
+
+  l = (size_t) vsnwprintf(fmt, args);
+  d = str_buf_alloc(l);
+  vswprintf(d, l + 1, fmt, args);
+  va_end(args);
+
+  return str_buf_str(d, l);
+}
+
+d4_str_t d4_str_calloc (const wchar_t *self, size_t length) {
+  if (length == 0) {
+    return d4_str_empty_val;
+  } else if (str_is_tiny(self, length)) {
+    return str_tiny(self[0]);
+  }
+
+  return str_dup(self, length);
+}
+
+d4_str_t d4_str_appendMove (d4_str_t self, const d4_str_t other) {
+  size_t len = self.len + other.len;
+  d4_str_t result;
+
+  if (!str_is_unique(self) || str_overlaps(self, other)) {
+    result = d4_str_concat(self, other);
+    d4_str_free(self);
+    return result;
+  } else if (other.len == 0) {
+    return self;
+  }
+
+  if (len > str_buf(self.data)->cap) {
+    self.data = str_buf_realloc(self.data, len > str_buf(self.data)->cap * 2 ? len : str_buf(self.data)->cap * 2);
+  }
+
+  wmemcpy(&self.data[self.len], other.data, other.len);
+  return str_buf_update(self.data, len);
+}
+
+wchar_t *d4_str_at (d4_err_state_t *state, int line, int col, const d4_str_t self, int32_t index) {
+  return &self.data[str_at_index(state, line, col, self.len, index)];
+}
+
+wchar_t *d4_str_atMut (d4_err_state_t *state, int line, int col, d4_str_t *self, int32_t index) {
+  size_t i = str_at_index(state, line, col, self->len, index);
+
+  if (self->is_static && !self->is_shared) {
+    d4_str_t message = d4_str_alloc(L"string view can't be modified");
+    d4_error_assign_generic(state, line, col, message);
+    d4_str_free(message);
+    longjmp(state->buf_last->buf, state->id);
+  } else if (self->is_shared && !str_is_unique(*self)) {
+    d4_str_t detached = str_dup(self->data, self->len);
+    d4_str_free(*self);
+    *self = detached;
+  } else if (self->is_shared) {
+    str_buf_update(self->data, self->len);
+  }
+
+  return &self->data[i];
+}
+
+bool d4_str_allOf (const d4_str_t self, d4_str_pred_cb predicate) {
+  unsigned char props = str_pred_props(predicate);
+
+  if (props != 0) {
+    return str_props_skip(self.data, self.len, 0, props) == self.len;
+  }
+
+  for (size_t i = 0; i < self.len; i++) {
+    if (!predicate(self.data[i])) return false;
+  }
+
+  return true;
+}
+
+d4_str_builder_t d4_str_builder_alloc (size_t cap) {
+  return (d4_str_builder_t) {cap == 0 ? NULL : str_buf_alloc(cap), 0, cap};
+}
+
+void d4_str_builder_appendFloat (d4_str_builder_t *self, double num) {
+  wchar_t buf[D4_FLOAT_BUF_LEN];
+  str_builder_append(self, buf, d4_float_write(buf, num, false));
+}
+
+void d4_str_builder_appendInt (d4_str_builder_t *self, int64_t num) {
+  str_builder_append_int(self, num < 0 ? (uint64_t) 0 - (uint64_t) num : (uint64_t) num, num < 0);
+}
+
+void d4_str_builder_appendStr (d4_str_builder_t *self, const d4_str_t str) {
+  str_builder_append(self, str.data, str.len);
+}
+
+void d4_str_builder_appendWchar (d4_str_builder_t *self, wchar_t c) {
+  str_builder_reserve(self, 1);
+  self->data[self->len++] = c;
+}
+
+d4_str_t d4_str_builder_finish (d4_str_builder_t *self) {
+  d4_str_t result = d4_str_empty_val;
+
+  if (self->len != 0) {
+    result = str_buf_str(self->data, self->len);
+  } else if (self->data != NULL) {
+    str_buf_free(self->data);
+  }
+
+  *self = (d4_str_builder_t) {NULL, 0, 0};
+  return result;
+}
+
+void d4_str_builder_free (d4_str_builder_t self) {
+  if (self.data != NULL) str_buf_free(self.data);
+}
+
+int d4_str_cmp (const d4_str_t self, const d4_str_t rhs) {
+  size_t len = self.len < rhs.len ? self.len : rhs.len;
+  size_t i = self.data == rhs.data ? len : str_mismatch(self.data, rhs.data, len);
+
+  if (i != len) {
+    return self.data[i] < rhs.data[i] ? -1 : 1;
+  }
+
+  return self.len < rhs.len ? -1 : self.len > rhs.len ? 1 : 0;
+}
+
+int d4_str_cmpIgnoreCase (const d4_str_t self, const d4_str_t rhs) {
+  size_t len = self.len < rhs.len ? self.len : rhs.len;
+  size_t i = self.data == rhs.data ? len : str_mismatch_fold(self.data, rhs.data, len);
+
+  if (i != len) {
+    return d4_rune_fold(self.data[i]) < d4_rune_fold(rhs.data[i]) ? -1 : 1;
+  }
+
+  return self.len < rhs.len ? -1 : self.len > rhs.len ? 1 : 0;
+}
+
+d4_str_t d4_str_concat (const d4_str_t self, const d4_str_t other) {
+  size_t l = self.len + other.len;
+  wchar_t *d;
+
+  if (self.len == 0) {
+    return d4_str_calloc(other.data, other.len);
+  } else if (other.len == 0) {
+    return d4_str_calloc(self.data, self.len);
+  }
+
+  d = str_buf_alloc(l);
+  wmemcpy(d, self.data, self.len);
+  wmemcpy(&d[self.len], other.data, other.len);
+
+  return str_buf_str(d, l);
+}
+
+bool d4_str_contains (const d4_str_t self, const d4_str_t search) {
+  return d4_str_find(self, search) != -1;
+}
+
+d4_str_t d4_str_copy (const d4_str_t self) {
+  if (self.is_shared) {
+    if (!self.is_static) STR_REFS_INCREMENT(&str_buf(self.data)->refs);
+    return self;
+  }
+
+  return d4_str_calloc(self.data, self.len);
+}
+
+size_t d4_str_countIf (const d4_str_t self, d4_str_pred_cb predicate) {
+  unsigned char props = str_pred_props(predicate);
+  size_t result = 0;
+
+  if (props != 0) {
+    return str_props_count(self.data, self.len, props);
+  }
+
+  for (size_t i = 0; i < self.len; i++) {
+    if (predicate(self.data[i])) result++;
+  }
+
+  return result;
+}
+
+bool d4_str_empty (const d4_str_t self) {
+  return self.len == 0;
+}
+
+bool d4_str_eq (const d4_str_t self, const d4_str_t rhs) {
+  size_t self_hash;
+  size_t rhs_hash;
+
+  if (self.data == rhs.data || self.len != rhs.len) {
+    return self.len == rhs.len;
+  } else if (str_is_interned(self) && str_is_interned(rhs)) {
+    return false;
+  }
+
+  self_hash = str_hash_cached(self);
+  rhs_hash = str_hash_cached(rhs);
+
+  if (self_hash != 0 && rhs_hash != 0 && self_hash != rhs_hash) {
+    return false;
+  }
+
+  return self.len == 0 || memcmp(self.data, rhs.data, self.len * sizeof(wchar_t)) == 0;
+}
+
+bool d4_str_eqIgnoreCase (const d4_str_t self, const d4_str_t rhs) {
+  return self.len == rhs.len && (self.data == rhs.data || str_mismatch_fold(self.data, rhs.data, self.len) == self.len);
+}
+
+bool d4_str_eq_hashed (const d4_str_t self, const d4_str_t rhs) {
+  if (self.len == rhs.len && self.is_shared && rhs.is_shared && d4_str_hash(self) != d4_str_hash(rhs)) {
+    return false;
+  }
+
+  return d4_str_eq(self, rhs);
+}
+
+d4_str_t d4_str_escape (const d4_str_t self) {
+  size_t len = str_escape_len(self);
+  wchar_t *d;
+
+  if (len == self.len) {
+    return d4_str_copy(self);
+  }
+
+  d = str_buf_alloc(len);
+  str_escape_write(d, self);
+  return str_buf_str(d, len);
+}
+
+int32_t d4_str_find (const d4_str_t self, const d4_str_t search) {
+  const wchar_t *result;
+
+  if (search.len == 0) {
+    return 0;
+  } else if (search.len > self.len) {
+    return -1;
+  }
+
+  result = str_search(self.data, self.len, search.data, search.len);
+  return result == NULL ? -1 : (int32_t) (result - self.data);
+}
+
+int32_t d4_str_findIgnoreCase (const d4_str_t self, const d4_str_t search) {
+  const wchar_t *result;
+
+  if (search.len == 0) {
+    return 0;
+  } else if (search.len > self.len) {
+    return -1;
+  }
+
+  result = str_search_fold(self.data, self.len, search.data, search.len);
+  return result == NULL ? -1 : (int32_t) (result - self.data);
+}
+
+void d4_str_free (d4_str_t self) {
+  if (self.is_static) {
+    return;
+  } else if (!self.is_shared) {
+    d4_safe_free(self.data);
+  } else if (STR_REFS_DECREMENT(&str_buf(self.data)->refs) == 0) {
+    str_buf_free(self.data);
+  }
+}
+
+bool d4_str_ge (const d4_str_t self, const d4_str_t rhs) {
+  return d4_str_cmp(self, rhs) >= 0;
+}
+
+bool d4_str_gt (const d4_str_t self, const d4_str_t rhs) {
+  return d4_str_cmp(self, rhs) > 0;
+}
+
+size_t d4_str_hash (const d4_str_t self) {
+  size_t result = str_hash_cached(self);
+
+  if (result != 0) {
+    return result;
+  }
+
+  result = 0xcbf29ce484222325;
+
+  for (size_t i = 0; i < self.len; i++) {
+    result *= 0x100000001b3;
+    result ^= (size_t) self.data[i];
+  }
+
+  if (self.is_shared) STR_HASH_STORE(&str_buf(self.data)->hash, result);
+  return result;
+}
+
+d4_str_t d4_str_intern (const d4_str_t self) {
+  d4_str_t result;
+  size_t index;
+
+  if (str_is_interned(self)) {
+    return self;
+  }
+
+  STR_INTERN_LOCK();
+
+  if (d4_map_should_reserve(str_intern_cap, str_intern_stats.len + 1)) {
+    size_t new_cap = d4_map_calc_cap(str_intern_cap == 0 ? 0x40 : str_intern_cap, str_intern_stats.len + 1);
+    d4_str_t *new_table = d4_safe_alloc(new_cap * sizeof(d4_str_t));
+
+    for (size_t i = 0; i < new_cap; i++) {
+      new_table[i] = d4_str_empty_val;
+    }
+
+    for (size_t i = 0; i < str_intern_cap; i++) {
+      if (str_intern_table[i].data == NULL) continue;
+      index = d4_map_hash(str_intern_table[i], new_cap);
+      while (new_table[index].data != NULL) index = (index + 1) % new_cap;
+      new_table[index] = str_intern_table[i];
+    }
+
+    d4_safe_free(str_intern_table);
+    str_intern_table = new_table;
+    str_intern_cap = new_cap;
+  }
+
+  index = d4_map_hash(self, str_intern_cap);
+
+  while (str_intern_table[index].data != NULL && !d4_str_eq(str_intern_table[index], self)) {
+    index = (index + 1) % str_intern_cap;
+  }
+
+  if (str_intern_table[index].data != NULL) {
+    str_intern_stats.hits++;
+  } else {
+    wchar_t *d = str_buf_alloc(self.len);
+    if (self.len != 0) wmemcpy(d, self.data, self.len);
+    // Hash is computed before the string is published, so that threads sharing it never write to its header.
+    str_buf(d)->hash = d4_str_hash(self);
+    str_buf(d)->is_interned = true;
+    d[self.len] = L'\0';
+    str_intern_table[index] = (d4_str_t) {d, self.len, true, true};
+    str_intern_stats.misses++;
+    str_intern_stats.len++;
+  }
+
+  result = str_intern_table[index];
+  STR_INTERN_UNLOCK();
+
+  return result;
+}
+
+d4_str_intern_stats_t d4_str_intern_stats (void) {
+  d4_str_intern_stats_t result;
+
+  STR_INTERN_LOCK();
+  result = str_intern_stats;
+  STR_INTERN_UNLOCK();
+
+  return result;
+}
+
+bool d4_str_le (const d4_str_t self, const d4_str_t rhs) {
+  return d4_str_cmp(self, rhs) <= 0;
+}
+
+bool d4_str_lt (const d4_str_t self, const d4_str_t rhs) {
+  return d4_str_cmp(self, rhs) < 0;
+}
+
+d4_str_t d4_str_quoted_escape (d4_str_t self) {
+  size_t len = str_escape_len(self) + 2;
+  wchar_t *d = str_buf_alloc(len);
+
+  d[0] = L'"';
+  str_escape_write(&d[1], self);
+  d[len - 1] = L'"';
+
+  return str_buf_str(d, len);
+}
+
+d4_str_t d4_str_realloc (d4_str_t self, const d4_str_t rhs) {
+  d4_str_t result;
+
+  if (self.data == rhs.data && self.len == rhs.len) {
+    return self;
+  }
+
+  result = d4_str_copy(rhs);
+  d4_str_free(self);
+  return result;
+}
+
+d4_arr_str_t d4_str_lines (const d4_str_t self, unsigned char o1, bool keepLineBreaks) {
+  d4_str_lines_iter_t it = d4_str_lines_iter(self, o1, keepLineBreaks);
+  d4_str_view_t line;
+  d4_str_t *result;
+  size_t len = 0;
+
+  while (d4_str_lines_iter_next(&it, &line)) len++;
+
+  if (len == 0) {
+    return (d4_arr_str_t) {NULL, 0};
+  }
+
+  result = d4_safe_alloc(len * sizeof(d4_str_t));
+  it = d4_str_lines_iter(self, o1, keepLineBreaks);
+
+  for (size_t i = 0; d4_str_lines_iter_next(&it, &line); i++) {
+    result[i] = d4_str_calloc(line.data, line.len);
+  }
+
+  return (d4_arr_str_t) {result, len};
+}
+
+d4_str_lines_iter_t d4_str_lines_iter (const d4_str_t self, unsigned char o1, bool keepLineBreaks) {
+  return (d4_str_lines_iter_t) {self, 0, o1 == 0 ? false : keepLineBreaks};
+}
+
+bool d4_str_lines_iter_next (d4_str_lines_iter_t *self, d4_str_view_t *line) {
+  size_t start = self->pos;
+  size_t end = start;
+
+  if (start >= self->str.len) {
+    return false;
+  }
+
+  while (end < self->str.len && self->str.data[end] != L'\n' && self->str.data[end] != L'\r') end++;
+  self->pos = end;
+
+  if (end < self->str.len) {
+    self->pos++;
+    if (self->str.data[end] == L'\r' && self->pos < self->str.len && self->str.data[self->pos] == L'\n') self->pos++;
+  }
+
+  *line = (d4_str_view_t) {&self->str.data[start], (self->keep_line_breaks ? self->pos : end) - start, true, false};
+  return true;
+}
+
+d4_str_t d4_str_lower (const d4_str_t self) {
+  wchar_t *d;
+
+  if (self.len == 0) {
+    return d4_str_empty_val;
+  } else if (str_is_tiny(self.data, self.len)) {
+    return str_tiny(d4_rune_lower(self.data[0]));
+  }
+
+  d = str_buf_alloc(self.len);
+  str_case_map(d, self.data, self.len, true);
+
+  return str_buf_str(d, self.len);
+}
+
+d4_str_t d4_str_lowerFirst (const d4_str_t self) {
+  d4_str_t d;
+
+  if (self.len == 0) {
+    return d4_str_empty_val;
+  } else if (str_is_tiny(self.data, self.len)) {
+    return str_tiny(d4_rune_lower(self.data[0]));
+  }
+
+  d = str_dup(self.data, self.len);
+  d.data[0] = d4_rune_lower(d.data[0]);
+  return d;
+}
+
+d4_str_t d4_str_lowerInPlace (d4_str_t self) {
+  d4_str_t result;
+
+  if (!str_is_unique(self)) {
+    result = d4_str_lower(self);
+    d4_str_free(self);
+    return result;
+  }
+
+  str_case_map(self.data, self.data, self.len, true);
+  return str_buf_update(self.data, self.len);
+}
+
+d4_str_matcher_t d4_str_matcher_alloc (const d4_arr_str_t patterns) {
+  str_matcher_t *m = d4_safe_alloc(sizeof(str_matcher_t));
+  size_t nodes_cap = 1;
+  size_t nodes_len = 1;
+  size_t edges_len = 0;
+  size_t *queue;
+
+  for (size_t i = 0; i < patterns.len; i++) {
+    nodes_cap += patterns.data[i].len;
+  }
+
+  m->nodes = d4_safe_alloc(nodes_cap * sizeof(str_matcher_node_t));
+  m->edges = d4_safe_alloc(nodes_cap * sizeof(size_t));
+  m->lens = d4_safe_alloc((patterns.len + 1) * sizeof(size_t));
+  m->nodes[0] = (str_matcher_node_t) {L'\0', 0, 0, 0, 0, 0, 0, 0};
+
+  for (size_t i = 0; i < patterns.len; i++) {
+    size_t state = 0;
+    m->lens[i] = patterns.data[i].len;
+
+    for (size_t j = 0; j < patterns.data[i].len; j++) {
+      wchar_t c = patterns.data[i].data[j];
+      size_t next = m->nodes[state].child;
+
+      while (next != 0 && m->nodes[next].c != c) {
+        next = m->nodes[next].sibling;
+      }
+
+      if (next == 0) {
+        next = nodes_len++;
+        m->nodes[next] = (str_matcher_node_t) {c, 0, m->nodes[state].child, 0, 0, 0, j + 1, 0};
+        m->nodes[state].child = next;
+      }
+
+      state = next;
+    }
+
+    if (state != 0 && m->nodes[state].match == 0) {
+      m->nodes[state].match = i + 1;
+    }
+  }
+
+  queue = d4_safe_alloc(nodes_len * sizeof(size_t));
+  queue[0] = 0;
+
+  for (size_t head = 0, tail = 1; head < tail; head++) {
+    size_t u = queue[head];
+    m->nodes[u].edges = edges_len;
+
+    for (size_t v = m->nodes[u].child; v != 0; v = m->nodes[v].sibling) {
+      size_t j = edges_len++;
+
+      while (j > m->nodes[u].edges && m->nodes[m->edges[j - 1]].c > m->nodes[v].c) {
+        m->edges[j] = m->edges[j - 1];
+        j--;
+      }
+
+      m->edges[j] = v;
+    }
+
+    m->nodes[u].edges_len = edges_len - m->nodes[u].edges;
+
+    for (size_t k = m->nodes[u].edges; k < edges_len; k++) {
+      size_t v = m->edges[k];
+      m->nodes[v].fail = u == 0 ? 0 : str_matcher_next(m, m->nodes[u].fail, m->nodes[v].c);
+      if (m->nodes[v].match == 0) m->nodes[v].match = m->nodes[m->nodes[v].fail].match;
+      queue[tail++] = v;
+    }
+  }
+
+  d4_safe_free(queue);
+  return (d4_str_matcher_t) {m, patterns.len};
+}
+
+size_t d4_str_matcher_findAll (const d4_str_matcher_t self, const d4_str_t haystack, d4_str_match_t *matches, size_t cap) {
+  d4_str_match_t match;
+  size_t from = 0;
+  size_t l = 0;
+
+  while (str_matcher_search(self.ctx, haystack, &from, &match)) {
+    if (l < cap) matches[l] = match;
+    l++;
+  }
+
+  return l;
+}
+
+void d4_str_matcher_free (d4_str_matcher_t self) {
+  str_matcher_t *m = self.ctx;
+
+  d4_safe_free(m->nodes);
+  d4_safe_free(m->edges);
+  d4_safe_free(m->lens);
+  d4_safe_free(m);
+}
+
+d4_str_t d4_str_matcher_replace (const d4_str_matcher_t self, const d4_str_t haystack, const d4_arr_str_t replacements) {
+  d4_str_builder_t result;
+  d4_str_match_t match;
+  size_t from = 0;
+  size_t i = 0;
+
+  if (!str_matcher_search(self.ctx, haystack, &from, &match)) {
+    return d4_str_copy(haystack);
+  }
+
+  result = d4_str_builder_alloc(haystack.len);
+
+  do {
+    d4_str_builder_appendStr(&result, (d4_str_view_t) {&haystack.data[i], (size_t) match.start - i, true, false});
+    if (match.pattern < replacements.len) d4_str_builder_appendStr(&result, replacements.data[match.pattern]);
+    i = from;
+  } while (str_matcher_search(self.ctx, haystack, &from, &match));
+
+  d4_str_builder_appendStr(&result, (d4_str_view_t) {&haystack.data[i], haystack.len - i, true, false});
+  return d4_str_builder_finish(&result);
+}
+
+bool d4_str_not (const d4_str_t self) {
+  return self.len == 0;
+}
+
+d4_str_t d4_str_persist (const wchar_t *data, size_t len) {
+  wchar_t *d = str_buf_alloc(len);
+  if (len != 0) wmemcpy(d, data, len);
+  d[len] = L'\0';
+  return (d4_str_t) {d, len, true, true};
+}
+
+d4_str_t d4_str_replace (const d4_str_t self, const d4_str_t search, const d4_str_t replacement, unsigned char o3, int32_t count) {
+  size_t shift[STR_SEARCHER_SHIFT_LEN];
+  d4_str_searcher_t searcher = {search, NULL};
+
+  if (search.len > STR_SEARCH_TWO_WAY_MIN) {
+    str_searcher_shift(shift, search);
+    searcher.shift = shift;
+  }
+
+  return d4_str_searcher_replace(searcher, self, replacement, o3, count);
+}
+
+d4_str_t d4_str_replaceInto (d4_str_t self, const d4_str_t search, const d4_str_t replacement, unsigned char o3, int32_t count) {
+  size_t shift[STR_SEARCHER_SHIFT_LEN];
+  d4_str_searcher_t searcher = {search, NULL};
+  size_t i = 0;
+  size_t k = 0;
+  d4_str_t result;
+  const wchar_t *p;
+
+  if (
+    !str_is_unique(self) ||
+    search.len == 0 ||
+    replacement.len > search.len ||
+    str_overlaps(self, search) ||
+    str_overlaps(self, replacement)
+  ) {
+    result = d4_str_replace(self, search, replacement, o3, count);
+    d4_str_free(self);
+    return result;
+  } else if (search.len > self.len) {
+    return self;
+  }
+
+  if (search.len > STR_SEARCH_TWO_WAY_MIN) {
+    str_searcher_shift(shift, search);
+    searcher.shift = shift;
+  }
+
+  // Replacement is not longer than search, so written part never reaches the part that is not searched yet.
+  for (int32_t n = 0; count <= 0 || n < count; n++) {
+    size_t j;
+
+    if ((p = str_searcher_search(searcher, &self.data[i], self.len - i)) == NULL) {
+      break;
+    }
+
+    j = (size_t) (p - self.data);
+    wmemmove(&self.data[k], &self.data[i], j - i);
+    k += j - i;
+    wmemcpy(&self.data[k], replacement.data, replacement.len);
+    k += replacement.len;
+    i = j + search.len;
+  }
+
+  if (i == 0) {
+    return self;
+  }
+
+  wmemmove(&self.data[k], &self.data[i], self.len - i);
+  k += self.len - i;
+
+  if (k == 0) {
+    d4_str_free(self);
+    return d4_str_empty_val;
+  }
+
+  return str_buf_update(self.data, k);
+}
+
+d4_str_rope_t d4_str_rope_alloc (const d4_str_t str) {
+  return (d4_str_rope_t) {str.len == 0 ? NULL : str_rope_leaf(d4_str_copy(str), 0, str.len), str.len};
+}
+
+d4_str_rope_t d4_str_rope_append (const d4_str_rope_t self, const d4_str_t str) {
+  d4_str_rope_t other = d4_str_rope_alloc(str);
+  return (d4_str_rope_t) {str_rope_join(str_rope_retain(self.ctx), other.ctx), self.len + other.len};
+}
+
+wchar_t d4_str_rope_at (d4_err_state_t *state, int line, int col, const d4_str_rope_t self, int32_t index) {
+  const str_rope_node_t *node;
+  size_t i;
+
+  if ((index >= 0 && (size_t) index >= self.len) || (index < 0 && index < -((int32_t) self.len))) {
+    d4_str_t message = d4_str_alloc(L"index %" PRId32 L" out of rope bounds", index);
+    d4_error_assign_generic(state, line, col, message);
+    d4_str_free(message);
+    longjmp(state->buf_last->buf, state->id);
+  }
+
+  i = index < 0 ? self.len + (size_t) index : (size_t) index;
+  node = str_rope_find(self.ctx, &i);
+  return node->str.data[node->start + i];
+}
+
+d4_str_rope_t d4_str_rope_concat (const d4_str_rope_t self, const d4_str_rope_t other) {
+  return (d4_str_rope_t) {str_rope_join(str_rope_retain(self.ctx), str_rope_retain(other.ctx)), self.len + other.len};
+}
+
+d4_str_rope_t d4_str_rope_copy (const d4_str_rope_t self) {
+  return (d4_str_rope_t) {str_rope_retain(self.ctx), self.len};
+}
+
+void d4_str_rope_free (d4_str_rope_t self) {
+  str_rope_release(self.ctx);
+}
+
+d4_str_rope_t d4_str_rope_insert (d4_err_state_t *state, int line, int col, const d4_str_rope_t self, int32_t index, const d4_str_t str) {
+  d4_str_rope_t other;
+  str_rope_node_t *left;
+  str_rope_node_t *right;
+  size_t i;
+
+  if ((index >= 0 && (size_t) index > self.len) || (index < 0 && index < -((int32_t) self.len))) {
+    d4_str_t message = d4_str_alloc(L"index %" PRId32 L" out of rope bounds", index);
+    d4_error_assign_generic(state, line, col, message);
+    d4_str_free(message);
+    longjmp(state->buf_last->buf, state->id);
+  }
+
+  i = index < 0 ? self.len + (size_t) index : (size_t) index;
+  other = d4_str_rope_alloc(str);
+  str_rope_split(self.ctx, i, &left, &right);
+  return (d4_str_rope_t) {str_rope_join(str_rope_join(left, other.ctx), right), self.len + other.len};
+}
+
+d4_str_rope_iter_t d4_str_rope_iter (const d4_str_rope_t self) {
+  return (d4_str_rope_iter_t) {self, 0};
+}
+
+bool d4_str_rope_iter_next (d4_str_rope_iter_t *self, d4_str_view_t *chunk) {
+  const str_rope_node_t *node;
+  size_t i = self->pos;
+
+  if (self->pos >= self->rope.len) {
+    return false;
+  }
+
+  node = str_rope_find(self->rope.ctx, &i);
+  *chunk = (d4_str_view_t) {&node->str.data[node->start + i], node->len - i, true, false};
+  self->pos += node->len - i;
+  return true;
+}
+
+d4_str_rope_t d4_str_rope_slice (const d4_str_rope_t self, unsigned char o1, int32_t start, unsigned char o2, int32_t end) {
+  str_rope_node_t *head;
+  str_rope_node_t *tail;
+  str_rope_node_t *result;
+  size_t i;
+  size_t j;
+
+  if (!str_slice_range(self.len, o1, start, o2, end, &i, &j)) {
+    return (d4_str_rope_t) {NULL, 0};
+  }
+
+  str_rope_split(self.ctx, j, &head, &tail);
+  str_rope_release(tail);
+  str_rope_split(head, i, &tail, &result);
+  str_rope_release(tail);
+  str_rope_release(head);
+  return (d4_str_rope_t) {result, j - i};
+}
+
+d4_str_t d4_str_rope_str (const d4_str_rope_t self) {
+  const str_rope_node_t *root = self.ctx;
+  d4_str_rope_iter_t it = d4_str_rope_iter(self);
+  d4_str_view_t chunk;
+  wchar_t *d;
+  size_t k = 0;
+
+  if (self.len == 0) {
+    return d4_str_empty_val;
+  } else if (root->height == 1 && root->start == 0 && root->len == root->str.len) {
+    return d4_str_copy(root->str);
+  }
+
+  d = str_buf_alloc(self.len);
+
+  while (d4_str_rope_iter_next(&it, &chunk)) {
+    wmemcpy(&d[k], chunk.data, chunk.len);
+    k += chunk.len;
+  }
+
+  return str_buf_str(d, self.len);
+}
+
+d4_str_t d4_str_slice (const d4_str_t self, unsigned char o1, int32_t start, unsigned char o2, int32_t end) {
+  return d4_str_copy(d4_str_sliceView(self, o1, start, o2, end));
+}
+
+d4_str_view_t d4_str_sliceView (const d4_str_t self, unsigned char o1, int32_t start, unsigned char o2, int32_t end) {
+  size_t i;
+  size_t j;
+
+  if (!str_slice_range(self.len, o1, start, o2, end, &i, &j)) {
+    return d4_str_empty_val;
+  }
+
+  return (d4_str_view_t) {&self.data[i], j - i, true, false};
+}
+
+d4_str_searcher_t d4_str_searcher_alloc (const d4_str_t needle) {
+  d4_str_searcher_t result = {d4_str_copy(needle), NULL};
+
+  if (needle.len > STR_SEARCH_TWO_WAY_MIN) {
+    result.shift = d4_safe_alloc(STR_SEARCHER_SHIFT_LEN * sizeof(size_t));
+    str_searcher_shift(result.shift, needle);
+  }
+
+  return result;
+}
+
+size_t d4_str_searcher_count (const d4_str_searcher_t self, const d4_str_t haystack) {
+  return d4_str_searcher_findAll(self, haystack, NULL, 0);
+}
+
+int32_t d4_str_searcher_find (const d4_str_searcher_t self, const d4_str_t haystack) {
+  const wchar_t *result;
 
-  if (errno == ERANGE || r < -DBL_MAX || DBL_MAX < r) {
-    d4_str_t message = d4_str_alloc(L"value `%ls` out of range", self.data);
-    d4_error_assign_generic(state, line, col, message);
-    d4_str_free(message);
-  } else if (errno != 0 || e == self.data || *e != 0) {
-    d4_str_t message = d4_str_alloc(L"value `%ls` has invalid syntax", self.data);
-    d4_error_assign_generic(state, line, col, message);
-    d4_str_free(message);
+  if (self.needle.len == 0) {
+    return 0;
   }
 
-  if (state->id != -1) longjmp(state->buf_last->buf, state->id);
-  return r;
+  result = str_searcher_search(self, haystack.data, haystack.len);
+  return result == NULL ? -1 : (int32_t) (result - haystack.data);
 }
 
-ptrdiff_t d4_str_toIsize (d4_err_state_t *state, int line, int col, const d4_str_t self, unsigned char o1, int32_t radix) {
-  wchar_t *e = NULL;
-  long long r;
+size_t d4_str_searcher_findAll (const d4_str_searcher_t self, const d4_str_t haystack, int32_t *positions, size_t cap) {
+  size_t l = 0;
+  size_t i = 0;
+  const wchar_t *p;
 
-  if (o1 == 1 && (radix < 2 || radix > 36) && radix != 0) {
-    d4_str_t message = d4_str_alloc(L"radix %" PRId32 L" is invalid, must be >= 2 and <= 36, or 0", radix);
-    d4_error_assign_generic(state, line, col, message);
-    d4_str_free(message);
-    longjmp(state->buf_last->buf, state->id);
+  if (self.needle.len == 0) {
+    for (; l <= haystack.len && l < cap; l++) positions[l] = (int32_t) l;
+    return haystack.len + 1;
   }
 
-  errno = 0;
-  r = wcstoll(self.data, &e, o1 == 0 ? 10 : radix);
-
-  if (errno == ERANGE || r < PTRDIFF_MIN || PTRDIFF_MAX < r) {
-    d4_str_t message = d4_str_alloc(L"value `%ls` out of range", self.data);
-    d4_error_assign_generic(state, line, col, message);
-    d4_str_free(message);
-  } else if (errno != 0 || e == self.data || *e != 0) {
-    d4_str_t message = d4_str_alloc(L"value `%ls` has invalid syntax", self.data);
-    d4_error_assign_generic(state, line, col, message);
-    d4_str_free(message);
+  while (i < haystack.len && (p = str_searcher_search(self, &haystack.data[i], haystack.len - i)) != NULL) {
+    i = (size_t) (p - haystack.data);
+    if (l < cap) positions[l] = (int32_t) i;
+    i += self.needle.len;
+    l++;
   }
 
-  if (state->id != -1) longjmp(state->buf_last->buf, state->id);
-  return (ptrdiff_t) r;
+  return l;
 }
 
-int8_t d4_str_toI8 (d4_err_state_t *state, int line, int col, const d4_str_t self, unsigned char o1, int32_t radix) {
-  wchar_t *e = NULL;
-  long r;
+void d4_str_searcher_free (d4_str_searcher_t self) {
+  d4_str_free(self.needle);
+  d4_safe_free(self.shift);
+}
 
-  if (o1 == 1 && (radix < 2 || radix > 36) && radix != 0) {
-    d4_str_t message = d4_str_alloc(L"radix %" PRId32 L" is invalid, must be >= 2 and <= 36, or 0", radix);
-    d4_error_assign_generic(state, line, col, message);
-    d4_str_free(message);
-    longjmp(state->buf_last->buf, state->id);
-  }
+d4_str_t d4_str_searcher_replace (const d4_str_searcher_t self, const d4_str_t haystack, const d4_str_t replacement, D4_UNUSED unsigned char o3, int32_t count) {
+  d4_str_builder_t result;
+  size_t i = 0;
+  const wchar_t *p;
 
-  errno = 0;
-  r = wcstol(self.data, &e, o1 == 0 ? 10 : radix);
+  if (self.needle.len == 0 && replacement.len == 0) {
+    return d4_str_copy(haystack);
+  } else if (self.needle.len == 0) {
+    size_t l = count > 0 && (size_t) count <= haystack.len ? (size_t) count : haystack.len + 1;
+    result = d4_str_builder_alloc(haystack.len + l * replacement.len);
 
-  if (errno == ERANGE || r < INT8_MIN || INT8_MAX < r) {
-    d4_str_t message = d4_str_alloc(L"value `%ls` out of range", self.data);
-    d4_error_assign_generic(state, line, col, message);
-    d4_str_free(message);
-  } else if (errno != 0 || e == self.data || *e != 0) {
-    d4_str_t message = d4_str_alloc(L"value `%ls` has invalid syntax", self.data);
-    d4_error_assign_generic(state, line, col, message);
-    d4_str_free(message);
+    for (size_t j = 0; j <= haystack.len; j++) {
+      if (j < l) d4_str_builder_appendStr(&result, replacement);
+      if (j < haystack.len) d4_str_builder_appendWchar(&result, haystack.data[j]);
+    }
+
+    return d4_str_builder_finish(&result);
+  } else if (self.needle.len > haystack.len) {
+    return d4_str_copy(haystack);
   }
 
-  if (state->id != -1) longjmp(state->buf_last->buf, state->id);
-  return (int8_t) r;
-}
+  result = d4_str_builder_alloc(haystack.len);
 
-int16_t d4_str_toI16 (d4_err_state_t *state, int line, int col, const d4_str_t self, unsigned char o1, int32_t radix) {
-  wchar_t *e = NULL;
-  long r;
+  for (int32_t k = 0; count <= 0 || k < count; k++) {
+    size_t j;
 
-  if (o1 == 1 && (radix < 2 || radix > 36) && radix != 0) {
-    d4_str_t message = d4_str_alloc(L"radix %" PRId32 L" is invalid, must be >= 2 and <= 36, or 0", radix);
-    d4_error_assign_generic(state, line, col, message);
-    d4_str_free(message);
-    longjmp(state->buf_last->buf, state->id);
+    if ((p = str_searcher_search(self, &haystack.data[i], haystack.len - i)) == NULL) {
+      break;
+    }
+
+    j = (size_t) (p - haystack.data);
+    d4_str_builder_appendStr(&result, (d4_str_view_t) {&haystack.data[i], j - i, true, false});
+    d4_str_builder_appendStr(&result, replacement);
+    i = j + self.needle.len;
   }
 
-  errno = 0;
-  r = wcstol(self.data, &e, o1 == 0 ? 10 : radix);
+  d4_str_builder_appendStr(&result, (d4_str_view_t) {&haystack.data[i], haystack.len - i, true, false});
+  return d4_str_builder_finish(&result);
+}
 
-  if (errno == ERANGE || r < INT16_MIN || INT16_MAX < r) {
-    d4_str_t message = d4_str_alloc(L"value `%ls` out of range", self.data);
-    d4_error_assign_generic(state, line, col, message);
-    d4_str_free(message);
-  } else if (errno != 0 || e == self.data || *e != 0) {
-    d4_str_t message = d4_str_alloc(L"value `%ls` has invalid syntax", self.data);
-    d4_error_assign_generic(state, line, col, message);
-    d4_str_free(message);
+d4_arr_str_t d4_str_split (const d4_str_t self, unsigned char o1, const d4_str_t delimiter) {
+  d4_arr_str_t result = d4_str_splitView(self, o1, delimiter);
+
+  for (size_t i = 0; i < result.len; i++) {
+    result.data[i] = d4_str_copy(result.data[i]);
   }
 
-  if (state->id != -1) longjmp(state->buf_last->buf, state->id);
-  return (int16_t) r;
+  return result;
 }
 
-int32_t d4_str_toI32 (d4_err_state_t *state, int line, int col, const d4_str_t self, unsigned char o1, int32_t radix) {
-  wchar_t *e = NULL;
-  long r;
+d4_arr_str_t d4_str_splitView (const d4_str_t self, unsigned char o1, const d4_str_t delimiter) {
+  d4_str_split_iter_t it = d4_str_split_iter(self, o1, delimiter, 0, 0);
+  d4_str_view_t piece;
+  d4_str_view_t *result;
+  size_t len = 0;
 
-  if (o1 == 1 && (radix < 2 || radix > 36) && radix != 0) {
-    d4_str_t message = d4_str_alloc(L"radix %" PRId32 L" is invalid, must be >= 2 and <= 36, or 0", radix);
-    d4_error_assign_generic(state, line, col, message);
-    d4_str_free(message);
-    longjmp(state->buf_last->buf, state->id);
+  while (d4_str_split_iter_next(&it, &piece)) len++;
+
+  if (len == 0) {
+    return (d4_arr_str_t) {NULL, 0};
   }
 
-  errno = 0;
-  r = wcstol(self.data, &e, o1 == 0 ? 10 : radix);
+  result = d4_safe_alloc(len * sizeof(d4_str_view_t));
+  it = d4_str_split_iter(self, o1, delimiter, 0, 0);
 
-  if (errno == ERANGE || r < INT32_MIN || INT32_MAX < r) {
-    d4_str_t message = d4_str_alloc(L"value `%ls` out of range", self.data);
-    d4_error_assign_generic(state, line, col, message);
-    d4_str_free(message);
-  } else if (errno != 0 || e == self.data || *e != 0) {
-    d4_str_t message = d4_str_alloc(L"value `%ls` has invalid syntax", self.data);
-    d4_error_assign_generic(state, line, col, message);
-    d4_str_free(message);
+  for (size_t i = 0; d4_str_split_iter_next(&it, &piece); i++) {
+    result[i] = piece;
   }
 
-  if (state->id != -1) longjmp(state->buf_last->buf, state->id);
-  return (int32_t) r;
+  return (d4_arr_str_t) {result, len};
 }
 
-int64_t d4_str_toI64 (d4_err_state_t *state, int line, int col, const d4_str_t self, unsigned char o1, int32_t radix) {
-  wchar_t *e = NULL;
-  long long r;
+d4_str_split_iter_t d4_str_split_iter (
+  const d4_str_t self,
+  D4_UNUSED unsigned char o1,
+  const d4_str_t delimiter,
+  unsigned char o2,
+  int32_t maxSplits
+) {
+  return (d4_str_split_iter_t) {self, delimiter, 0, o2 == 0 || maxSplits <= 0 ? SIZE_MAX : (size_t) maxSplits, false};
+}
 
-  if (o1 == 1 && (radix < 2 || radix > 36) && radix != 0) {
-    d4_str_t message = d4_str_alloc(L"radix %" PRId32 L" is invalid, must be >= 2 and <= 36, or 0", radix);
-    d4_error_assign_generic(state, line, col, message);
-    d4_str_free(message);
-    longjmp(state->buf_last->buf, state->id);
+bool d4_str_split_iter_next (d4_str_split_iter_t *self, d4_str_view_t *piece) {
+  size_t start = self->pos;
+  const wchar_t *found = NULL;
+
+  if (self->done) {
+    return false;
+  } else if (self->str.len == 0) {
+    self->done = true;
+    *piece = (d4_str_view_t) {self->str.data, 0, true, false};
+    return self->delimiter.len != 0;
   }
 
-  errno = 0;
-  r = wcstoll(self.data, &e, o1 == 0 ? 10 : radix);
+  if (self->splits != 0 && self->delimiter.len == 0) {
+    found = start + 1 < self->str.len ? &self->str.data[start + 1] : NULL;
+  } else if (self->splits != 0) {
+    found = str_search(&self->str.data[start], self->str.len - start, self->delimiter.data, self->delimiter.len);
+  }
 
-  if (errno == ERANGE || r < INT64_MIN || INT64_MAX < r) {
-    d4_str_t message = d4_str_alloc(L"value `%ls` out of range", self.data);
-    d4_error_assign_generic(state, line, col, message);
-    d4_str_free(message);
-  } else if (errno != 0 || e == self.data || *e != 0) {
-    d4_str_t message = d4_str_alloc(L"value `%ls` has invalid syntax", self.data);
-    d4_error_assign_generic(state, line, col, message);
-    d4_str_free(message);
+  if (found == NULL) {
+    self->done = true;
+    *piece = (d4_str_view_t) {&self->str.data[start], self->str.len - start, true, false};
+    return true;
   }
 
-  if (state->id != -1) longjmp(state->buf_last->buf, state->id);
-  return (int64_t) r;
+  *piece = (d4_str_view_t) {&self->str.data[start], (size_t) (found - &self->str.data[start]), true, false};
+  self->pos = (size_t) (found - self->str.data) + self->delimiter.len;
+  if (self->splits != SIZE_MAX) self->splits--;
+
+  return true;
 }
 
-size_t d4_str_toUsize (d4_err_state_t *state, int line, int col, const d4_str_t self, unsigned char o1, int32_t radix) {
-  wchar_t *e = NULL;
-  unsigned long long r;
+d4_str_table_t d4_str_table_alloc (const d4_arr_str_t arr) {
+  size_t *offsets = d4_safe_alloc((arr.len + 1) * sizeof(size_t));
+  wchar_t *data;
+  size_t size = 0;
 
-  if (o1 == 1 && (radix < 2 || radix > 36) && radix != 0) {
-    d4_str_t message = d4_str_alloc(L"radix %" PRId32 L" is invalid, must be >= 2 and <= 36, or 0", radix);
-    d4_error_assign_generic(state, line, col, message);
-    d4_str_free(message);
-    longjmp(state->buf_last->buf, state->id);
+  for (size_t i = 0; i < arr.len; i++) {
+    size += arr.data[i].len + 1;
   }
 
-  errno = 0;
-  r = wcstoull(self.data, &e, o1 == 0 ? 10 : radix);
+  data = size == 0 ? NULL : d4_safe_alloc(size * sizeof(wchar_t));
+  offsets[0] = 0;
 
-  if (errno == ERANGE || SIZE_MAX < r) {
-    d4_str_t message = d4_str_alloc(L"value `%ls` out of range", self.data);
-    d4_error_assign_generic(state, line, col, message);
-    d4_str_free(message);
-  } else if (errno != 0 || e == self.data || *e != 0 || self.data[0] == L'-') {
-    d4_str_t message = d4_str_alloc(L"value `%ls` has invalid syntax", self.data);
-    d4_error_assign_generic(state, line, col, message);
-    d4_str_free(message);
+  for (size_t i = 0; i < arr.len; i++) {
+    if (arr.data[i].len != 0) wmemcpy(&data[offsets[i]], arr.data[i].data, arr.data[i].len);
+    data[offsets[i] + arr.data[i].len] = L'\0';
+    offsets[i + 1] = offsets[i] + arr.data[i].len + 1;
   }
 
-  if (state->id != -1) longjmp(state->buf_last->buf, state->id);
-  return (size_t) r;
+  return (d4_str_table_t) {data, offsets, arr.len};
 }
 
-uint8_t d4_str_toU8 (d4_err_state_t *state, int line, int col, const d4_str_t self, unsigned char o1, int32_t radix) {\
-  wchar_t *e = NULL;
-  unsigned long r;
+d4_str_view_t d4_str_table_at (d4_err_state_t *state, int line, int col, const d4_str_table_t self, int32_t index) {
+  size_t i;
 
-  if (o1 == 1 && (radix < 2 || radix > 36) && radix != 0) {
-    d4_str_t message = d4_str_alloc(L"radix %" PRId32 L" is invalid, must be >= 2 and <= 36, or 0", radix);
+  if ((index >= 0 && (size_t) index >= self.len) || (index < 0 && index < -((int32_t) self.len))) {
+    d4_str_t message = d4_str_alloc(L"index %" PRId32 L" out of table bounds", index);
     d4_error_assign_generic(state, line, col, message);
     d4_str_free(message);
     longjmp(state->buf_last->buf, state->id);
   }
 
-  errno = 0;
-  r = wcstoul(self.data, &e, o1 == 0 ? 10 : radix);
+  i = index < 0 ? self.len + (size_t) index : (size_t) index;
+  return (d4_str_view_t) {&self.data[self.offsets[i]], self.offsets[i + 1] - self.offsets[i] - 1, true, false};
+}
 
-  if (errno == ERANGE || UINT8_MAX < r) {
-    d4_str_t message = d4_str_alloc(L"value `%ls` out of range", self.data);
-    d4_error_assign_generic(state, line, col, message);
-    d4_str_free(message);
-  } else if (errno != 0 || e == self.data || *e != 0 || self.data[0] == L'-') {
-    d4_str_t message = d4_str_alloc(L"value `%ls` has invalid syntax", self.data);
-    d4_error_assign_generic(state, line, col, message);
-    d4_str_free(message);
+bool d4_str_table_contains (const d4_str_table_t self, const d4_str_t search) {
+  for (size_t i = 0; i < self.len; i++) {
+    if (
+      self.offsets[i + 1] - self.offsets[i] - 1 == search.len &&
+      (search.len == 0 || wmemcmp(&self.data[self.offsets[i]], search.data, search.len) == 0)
+    ) {
+      return true;
+    }
   }
 
-  if (state->id != -1) longjmp(state->buf_last->buf, state->id);
-  return (uint8_t) r;
+  return false;
 }
 
-uint16_t d4_str_toU16 (d4_err_state_t *state, int line, int col, const d4_str_t self, unsigned char o1, int32_t radix) {
-  wchar_t *e = NULL;
-  unsigned long r;
+void d4_str_table_free (d4_str_table_t self) {
+  if (self.data != NULL) d4_safe_free(self.data);
+  d4_safe_free(self.offsets);
+}
 
-  if (o1 == 1 && (radix < 2 || radix > 36) && radix != 0) {
-    d4_str_t message = d4_str_alloc(L"radix %" PRId32 L" is invalid, must be >= 2 and <= 36, or 0", radix);
-    d4_error_assign_generic(state, line, col, message);
-    d4_str_free(message);
-    longjmp(state->buf_last->buf, state->id);
+d4_str_t d4_str_table_join (const d4_str_table_t self, unsigned char o1, const d4_str_t separator) {
+  d4_str_t x = o1 == 0 ? (d4_str_t) {L",", 1, true, false} : separator;
+  wchar_t *data;
+  size_t len;
+  size_t k = 0;
+
+  if (self.len == 0) {
+    return d4_str_empty_val;
   }
 
-  errno = 0;
-  r = wcstoul(self.data, &e, o1 == 0 ? 10 : radix);
+  len = self.offsets[self.len] - self.len + (self.len - 1) * x.len;
 
-  if (errno == ERANGE || UINT16_MAX < r) {
-    d4_str_t message = d4_str_alloc(L"value `%ls` out of range", self.data);
-    d4_error_assign_generic(state, line, col, message);
-    d4_str_free(message);
-  } else if (errno != 0 || e == self.data || *e != 0 || self.data[0] == L'-') {
-    d4_str_t message = d4_str_alloc(L"value `%ls` has invalid syntax", self.data);
-    d4_error_assign_generic(state, line, col, message);
-    d4_str_free(message);
+  if (len == 0) {
+    return d4_str_empty_val;
   }
 
-  if (state->id != -1) longjmp(state->buf_last->buf, state->id);
-  return (uint16_t) r;
+  data = str_buf_alloc(len);
+
+  for (size_t i = 0; i < self.len; i++) {
+    size_t item_len = self.offsets[i + 1] - self.offsets[i] - 1;
+
+    if (i != 0 && x.len != 0) {
+      wmemcpy(&data[k], x.data, x.len);
+      k += x.len;
+    }
+
+    if (item_len != 0) {
+      wmemcpy(&data[k], &self.data[self.offsets[i]], item_len);
+      k += item_len;
+    }
+  }
+
+  return str_buf_str(data, len);
 }
 
-uint32_t d4_str_toU32 (d4_err_state_t *state, int line, int col, const d4_str_t self, unsigned char o1, int32_t radix) {
-  wchar_t *e = NULL;
-  unsigned long r;
+void d4_str_table_sort (d4_str_table_t *self) {
+  d4_arr_str_t items;
+  wchar_t *data;
 
-  if (o1 == 1 && (radix < 2 || radix > 36) && radix != 0) {
-    d4_str_t message = d4_str_alloc(L"radix %" PRId32 L" is invalid, must be >= 2 and <= 36, or 0", radix);
-    d4_error_assign_generic(state, line, col, message);
-    d4_str_free(message);
-    longjmp(state->buf_last->buf, state->id);
+  if (self->len < 2) {
+    return;
   }
 
-  errno = 0;
-  r = wcstoul(self.data, &e, o1 == 0 ? 10 : radix);
+  items = d4_str_table_toArr(*self);
+  qsort(items.data, items.len, sizeof(d4_str_view_t), str_qsort_cmp);
+  data = d4_safe_alloc(self->offsets[self->len] * sizeof(wchar_t));
 
-  if (errno == ERANGE || UINT32_MAX < r) {
-    d4_str_t message = d4_str_alloc(L"value `%ls` out of range", self.data);
-    d4_error_assign_generic(state, line, col, message);
-    d4_str_free(message);
-  } else if (errno != 0 || e == self.data || *e != 0 || self.data[0] == L'-') {
-    d4_str_t message = d4_str_alloc(L"value `%ls` has invalid syntax", self.data);
-    d4_error_assign_generic(state, line, col, message);
-    d4_str_free(message);
+  for (size_t i = 0; i < items.len; i++) {
+    wmemcpy(&data[self->offsets[i]], items.data[i].data, items.data[i].len + 1);
+    self->offsets[i + 1] = self->offsets[i] + items.data[i].len + 1;
   }
 
-  if (state->id != -1) longjmp(state->buf_last->buf, state->id);
-  return (uint32_t) r;
+  d4_safe_free(self->data);
+  d4_safe_free(items.data);
+  self->data = data;
 }
 
-uint64_t d4_str_toU64 (d4_err_state_t *state, int line, int col, const d4_str_t self, unsigned char o1, int32_t radix) {
-  wchar_t *e = NULL;
-  unsigned long long r;
+d4_arr_str_t d4_str_table_toArr (const d4_str_table_t self) {
+  d4_str_view_t *result;
 
-  if (o1 == 1 && (radix < 2 || radix > 36) && radix != 0) {
-    d4_str_t message = d4_str_alloc(L"radix %" PRId32 L" is invalid, must be >= 2 and <= 36, or 0", radix);
-    d4_error_assign_generic(state, line, col, message);
-    d4_str_free(message);
-    longjmp(state->buf_last->buf, state->id);
+  if (self.len == 0) {
+    return (d4_arr_str_t) {NULL, 0};
   }
 
-  errno = 0;
-  r = wcstoull(self.data, &e, o1 == 0 ? 10 : radix);
+  result = d4_safe_alloc(self.len * sizeof(d4_str_view_t));
 
-  if (errno == ERANGE || UINT64_MAX < r) {
-    d4_str_t message = d4_str_alloc(L"value `%ls` out of range", self.data);
-    d4_error_assign_generic(state, line, col, message);
-    d4_str_free(message);
-  } else if (errno != 0 || e == self.data || *e != 0 || self.data[0] == L'-') {
-    d4_str_t message = d4_str_alloc(L"value `%ls` has invalid syntax", self.data);
-    d4_error_assign_generic(state, line, col, message);
-    d4_str_free(message);
+  for (size_t i = 0; i < self.len; i++) {
+    result[i] = (d4_str_view_t) {&self.data[self.offsets[i]], self.offsets[i + 1] - self.offsets[i] - 1, true, false};
   }
 
-  if (state->id != -1) longjmp(state->buf_last->buf, state->id);
-  return (uint64_t) r;
+  return (d4_arr_str_t) {result, self.len};
 }
 
-d4_str_t d4_str_trim (const d4_str_t self) {
-  size_t i = 0;
-  size_t j = self.len;
-  size_t l;
+double d4_str_toFloat (d4_err_state_t *state, int line, int col, const d4_str_t self) {
+  return str_parse_float(state, line, col, self, false);
+}
 
-  if (self.len == 0) {
-    return self;
+void d4_str_toFloatAll (d4_err_state_t *state, int line, int col, const d4_arr_str_t self, double *result) {
+  for (size_t i = 0; i < self.len; i++) {
+    result[i] = str_parse_float(state, line, col, self.data[i], false);
   }
+}
 
-  while (i < self.len && isspace(self.data[i])) {
-    i++;
-  }
+float d4_str_toF32 (d4_err_state_t *state, int line, int col, const d4_str_t self) {
+  return (float) str_parse_float(state, line, col, self, true);
+}
 
-  while (isspace(self.data[j - 1])) {
-    j--;
-    if (j == 0) break;
+void d4_str_toF32All (d4_err_state_t *state, int line, int col, const d4_arr_str_t self, float *result) {
+  for (size_t i = 0; i < self.len; i++) {
+    result[i] = (float) str_parse_float(state, line, col, self.data[i], true);
   }
+}
 
-  if (i >= j) {
-    return d4_str_empty_val;
+double d4_str_toF64 (d4_err_state_t *state, int line, int col, const d4_str_t self) {
+  return str_parse_float(state, line, col, self, false);
+}
+
+void d4_str_toF64All (d4_err_state_t *state, int line, int col, const d4_arr_str_t self, double *result) {
+  for (size_t i = 0; i < self.len; i++) {
+    result[i] = str_parse_float(state, line, col, self.data[i], false);
   }
+}
+
+ptrdiff_t d4_str_toIsize (d4_err_state_t *state, int line, int col, const d4_str_t self, unsigned char o1, int32_t radix) {
+  return (ptrdiff_t) str_parse_signed(state, line, col, self, o1, radix, PTRDIFF_MIN, PTRDIFF_MAX);
+}
+
+int8_t d4_str_toI8 (d4_err_state_t *state, int line, int col, const d4_str_t self, unsigned char o1, int32_t radix) {
+  return (int8_t) str_parse_signed(state, line, col, self, o1, radix, INT8_MIN, INT8_MAX);
+}
+
+int16_t d4_str_toI16 (d4_err_state_t *state, int line, int col, const d4_str_t self, unsigned char o1, int32_t radix) {
+  return (int16_t) str_parse_signed(state, line, col, self, o1, radix, INT16_MIN, INT16_MAX);
+}
+
+int32_t d4_str_toI32 (d4_err_state_t *state, int line, int col, const d4_str_t self, unsigned char o1, int32_t radix) {
+  return (int32_t) str_parse_signed(state, line, col, self, o1, radix, INT32_MIN, INT32_MAX);
+}
+
+int64_t d4_str_toI64 (d4_err_state_t *state, int line, int col, const d4_str_t self, unsigned char o1, int32_t radix) {
+  return (int64_t) str_parse_signed(state, line, col, self, o1, radix, INT64_MIN, INT64_MAX);
+}
+
+size_t d4_str_toUsize (d4_err_state_t *state, int line, int col, const d4_str_t self, unsigned char o1, int32_t radix) {
+  return (size_t) str_parse_unsigned(state, line, col, self, o1, radix, SIZE_MAX);
+}
+
+uint8_t d4_str_toU8 (d4_err_state_t *state, int line, int col, const d4_str_t self, unsigned char o1, int32_t radix) {
+  return (uint8_t) str_parse_unsigned(state, line, col, self, o1, radix, UINT8_MAX);
+}
+
+uint16_t d4_str_toU16 (d4_err_state_t *state, int line, int col, const d4_str_t self, unsigned char o1, int32_t radix) {
+  return (uint16_t) str_parse_unsigned(state, line, col, self, o1, radix, UINT16_MAX);
+}
+
+uint32_t d4_str_toU32 (d4_err_state_t *state, int line, int col, const d4_str_t self, unsigned char o1, int32_t radix) {
+  return (uint32_t) str_parse_unsigned(state, line, col, self, o1, radix, UINT32_MAX);
+}
+
+uint64_t d4_str_toU64 (d4_err_state_t *state, int line, int col, const d4_str_t self, unsigned char o1, int32_t radix) {
+  return (uint64_t) str_parse_unsigned(state, line, col, self, o1, radix, UINT64_MAX);
+}
 
-  l = j - i;
-  return d4_str_calloc(&self.data[i], l);
+d4_str_t d4_str_trim (const d4_str_t self) {
+  return d4_str_copy(d4_str_trimView(self));
 }
 
 d4_str_t d4_str_trimEnd (const d4_str_t self) {
+  return d4_str_copy(d4_str_trimEndView(self));
+}
+
+d4_str_view_t d4_str_trimEndView (const d4_str_t self) {
   size_t l = self.len;
-  if (self.len == 0) return self;
 
-  while (isspace(self.data[l - 1])) {
+  while (l > 0 && (d4_rune_props(self.data[l - 1]) & D4_RUNE_WHITESPACE) != 0) {
     l--;
-
-    if (l == 0) {
-      return d4_str_empty_val;
-    }
   }
 
-  return d4_str_calloc(self.data, l);
+  return l == 0 ? d4_str_empty_val : (d4_str_view_t) {self.data, l, true, false};
 }
 
-d4_str_t d4_str_trimStart (const d4_str_t self) {
-  size_t i = 0;
-  size_t l;
+d4_str_t d4_str_trimInPlace (d4_str_t self) {
+  d4_str_view_t view;
+  d4_str_t result;
 
-  if (self.len == 0) {
-    return self;
+  if (!str_is_unique(self)) {
+    result = d4_str_trim(self);
+    d4_str_free(self);
+    return result;
   }
 
-  while (i < self.len && isspace(self.data[i])) {
-    i++;
-  }
+  view = d4_str_trimView(self);
 
-  if (i >= self.len) {
+  if (view.len == self.len) {
+    return self;
+  } else if (view.len == 0) {
+    d4_str_free(self);
     return d4_str_empty_val;
   }
 
-  l = self.len - i;
-  return d4_str_calloc(&self.data[i], l);
+  wmemmove(self.data, view.data, view.len);
+  return str_buf_update(self.data, view.len);
+}
+
+d4_str_t d4_str_trimStart (const d4_str_t self) {
+  return d4_str_copy(d4_str_trimStartView(self));
+}
+
+d4_str_view_t d4_str_trimStartView (const d4_str_t self) {
+  size_t i = str_props_skip(self.data, self.len, 0, D4_RUNE_WHITESPACE);
+
+  return i == self.len ? d4_str_empty_val : (d4_str_view_t) {&self.data[i], self.len - i, true, false};
+}
+
+d4_str_view_t d4_str_trimView (const d4_str_t self) {
+  return d4_str_trimEndView(d4_str_trimStartView(self));
 }
 
 d4_str_t d4_str_upper (const d4_str_t self) {
-  d4_str_t d = d4_str_copy(self);
+  wchar_t *d;
 
   if (self.len == 0) {
-    return d;
+    return d4_str_empty_val;
+  } else if (str_is_tiny(self.data, self.len)) {
+    return str_tiny(d4_rune_upper(self.data[0]));
   }
 
-  for (size_t i = 0; i < d.len; i++) {
-    d.data[i] = (wchar_t) toupper(d.data[i]);
-  }
+  d = str_buf_alloc(self.len);
+  str_case_map(d, self.data, self.len, false);
 
-  return d;
+  return str_buf_str(d, self.len);
 }
 
 d4_str_t d4_str_upperFirst (const d4_str_t self) {
-  d4_str_t d = d4_str_copy(self);
+  d4_str_t d;
 
   if (self.len == 0) {
-    return d;
+    return d4_str_empty_val;
+  } else if (str_is_tiny(self.data, self.len)) {
+    return str_tiny(d4_rune_upper(self.data[0]));
   }
 
-  d.data[0] = (wchar_t) toupper(d.data[0]);
+  d = str_dup(self.data, self.len);
+  d.data[0] = d4_rune_upper(d.data[0]);
   return d;
 }
+
+d4_str_t d4_str_upperInPlace (d4_str_t self) {
+  d4_str_t result;
+
+  if (!str_is_unique(self)) {
+    result = d4_str_upper(self);
+    d4_str_free(self);
+    return result;
+  }
+
+  str_case_map(self.data, self.data, self.len, false);
+  return str_buf_update(self.data, self.len);
+}
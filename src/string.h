@@ -8,6 +8,25 @@
 
 #include <d4/string.h>
 
+/**
+ * Compares two strings like d4_str_eq, but computes and caches hashes of shared strings of equal length to reject
+ * mismatches without comparing data next time. Used for elements of string arrays that are searched repeatedly.
+ * @param self String to compare from.
+ * @param rhs String to compare to.
+ * @return Whether strings are equal.
+ */
+bool d4_str_eq_hashed (const d4_str_t self, const d4_str_t rhs);
+
+/**
+ * Allocates static string with shared data that is never deallocated. Copies of such string share its data the same
+ * way as copies of interned strings do, and it's detached before it's modified. Used for strings cached for the
+ * lifetime of the process.
+ * @param data Wide characters to copy.
+ * @param len Number of wide characters to copy.
+ * @return Static string with shared data.
+ */
+d4_str_t d4_str_persist (const wchar_t *data, size_t len);
+
 int snwprintf (const wchar_t *, ...);
 int vsnwprintf (const wchar_t *, va_list);
 
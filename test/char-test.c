@@ -6,6 +6,7 @@
 #include <assert.h>
 #include "../src/char.h"
 #include "../src/string.h"
+#include "utils.h"
 
 static void test_char_byte (void) {
   assert(((void) "Generates byte of 'a'", d4_char_byte('a') == 0x61));
@@ -26,6 +27,7 @@ static void test_char_isLetter (void) {
   assert(((void) "Checks '@'", !d4_char_isLetter('@')));
   assert(((void) "Checks '0'", !d4_char_isLetter('0')));
   assert(((void) "Checks '9'", !d4_char_isLetter('9')));
+  assert(((void) "Checks byte above ASCII", !d4_char_isLetter((char) 0xE9)));
 }
 
 static void test_char_isLetterOrDigit (void) {
@@ -58,6 +60,9 @@ static void test_char_isWhitespace (void) {
   assert(((void) "Checks '@'", !d4_char_isWhitespace('@')));
   assert(((void) "Checks '0'", !d4_char_isWhitespace('0')));
   assert(((void) "Checks '9'", !d4_char_isWhitespace('9')));
+  assert(((void) "Checks ' '", d4_char_isWhitespace(' ')));
+  assert(((void) "Checks '\\t'", d4_char_isWhitespace('\t')));
+  assert(((void) "Checks byte above ASCII", !d4_char_isWhitespace((char) 0xA0)));
 }
 
 static void test_char_lower (void) {
@@ -112,6 +117,28 @@ static void test_char_str (void) {
   d4_str_free(a2);
 }
 
+static void test_char_str_detach (void) {
+  d4_str_t a1 = d4_char_str('x');
+  d4_str_t a2;
+  d4_str_t s1_cmp = d4_str_alloc(L"x");
+  d4_str_t s2_cmp = d4_str_alloc(L"y");
+
+  ASSERT_NO_THROW(AT1, {
+    *d4_str_atMut(&d4_err_state, 0, 0, &a1, 0) = L'y';
+  });
+
+  a2 = d4_char_str('x');
+
+  assert(((void) "Modifies detached string", d4_str_eq(a1, s2_cmp)));
+  assert(((void) "Doesn't modify later strings of the same character", d4_str_eq(a2, s1_cmp)));
+
+  d4_str_free(s1_cmp);
+  d4_str_free(s2_cmp);
+
+  d4_str_free(a1);
+  d4_str_free(a2);
+}
+
 static void test_char_upper (void) {
   assert(((void) "Transforms into uppercase 'A'", d4_char_upper('A') == 'A'));
   assert(((void) "Transforms into uppercase 'a'", d4_char_upper('a') == 'A'));
@@ -131,5 +158,6 @@ int main (void) {
   test_char_lower();
   test_char_repeat();
   test_char_str();
+  test_char_str_detach();
   test_char_upper();
 }
@@ -27,13 +27,17 @@ static void test_globals_print (void) {
   d4_str_t s_stdout = d4_str_alloc(L"stdout");
   d4_str_t s_stderr = d4_str_alloc(L"stderr");
   d4_str_t s_string = d4_str_alloc(L"string");
+  d4_str_t s_percent = d4_str_alloc(L"100%%ls%%d");
   d4_str_t result = d4_str_alloc(D4_EOL L"10 string" D4_EOL L"10,string");
+  d4_str_t result_stdout = d4_str_alloc(D4_EOL L"10 string" D4_EOL L"10,string100%%ls%%d");
 
   d4_any_t i1 = d4_any_int_alloc(10);
   d4_any_t i2 = d4_any_str_alloc(s_string);
+  d4_any_t i3 = d4_any_str_alloc(s_percent);
 
   d4_arr_any_t items1 = d4_arr_any_alloc(0);
   d4_arr_any_t items2 = d4_arr_any_alloc(2, i1, i2);
+  d4_arr_any_t items3 = d4_arr_any_alloc(1, i3);
 
   FILE *f = freopen(path, "w", stdout);
 
@@ -76,10 +80,36 @@ static void test_globals_print (void) {
     )
   );
 
+  d4_print.func(
+    d4_print.ctx,
+    d4_safe_calloc(
+      &(d4_fn_sFP4arr_anyFP1strFP1strFP1strFRvoidFE_params_t) {
+        items1,
+        0, s_e,
+        1, s_e,
+        0, s_e
+      },
+      sizeof(d4_fn_sFP4arr_anyFP1strFP1strFP1strFRvoidFE_params_t)
+    )
+  );
+
+  d4_print.func(
+    d4_print.ctx,
+    d4_safe_calloc(
+      &(d4_fn_sFP4arr_anyFP1strFP1strFP1strFRvoidFE_params_t) {
+        items3,
+        0, s_e,
+        1, s_e,
+        0, s_e
+      },
+      sizeof(d4_fn_sFP4arr_anyFP1strFP1strFP1strFRvoidFE_params_t)
+    )
+  );
+
   fclose(f);
   file_content = read_unicode_file(path);
   remove(path);
-  assert(((void) "Output is correct for stdout", d4_str_eq(file_content, result)));
+  assert(((void) "Output is correct for stdout", d4_str_eq(file_content, result_stdout)));
   d4_str_free(file_content);
 
   f = freopen(path, "w", stderr);
@@ -131,16 +161,20 @@ static void test_globals_print (void) {
 
   d4_arr_any_free(items1);
   d4_arr_any_free(items2);
+  d4_arr_any_free(items3);
 
   d4_any_free(i1);
   d4_any_free(i2);
+  d4_any_free(i3);
 
   d4_str_free(s_comma);
   d4_str_free(s_stderr);
   d4_str_free(s_stdout);
   d4_str_free(s_e);
+  d4_str_free(s_percent);
 
   d4_str_free(result);
+  d4_str_free(result_stdout);
 }
 
 int main (void) {
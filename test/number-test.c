@@ -6,56 +6,142 @@
 #include <assert.h>
 #include "../src/number.h"
 #include "../src/string.h"
+#include "utils.h"
 
 static void test_f32_str (void) {
   d4_str_t a1 = d4_f32_str(0.0f);
   d4_str_t a2 = d4_f32_str(12.34f);
+  d4_str_t a3 = d4_f32_str(0.3f);
+  d4_str_t a4 = d4_f32_str(-2.5f);
+  d4_str_t a5 = d4_f32_str(1e-7f);
+  d4_str_t a6 = d4_f32_str(16777216.0f);
+  d4_str_t a7 = d4_f32_str(-0.0f);
 
   d4_str_t s1_cmp = d4_str_alloc(L"0.0");
   d4_str_t s2_cmp = d4_str_alloc(L"12.34");
+  d4_str_t s3_cmp = d4_str_alloc(L"0.3");
+  d4_str_t s4_cmp = d4_str_alloc(L"-2.5");
+  d4_str_t s5_cmp = d4_str_alloc(L"0.0000001");
+  d4_str_t s6_cmp = d4_str_alloc(L"16777216.0");
+  d4_str_t s7_cmp = d4_str_alloc(L"-0.0");
 
   assert(((void) "Stringifies 0.0", d4_str_eq(a1, s1_cmp)));
   assert(((void) "Stringifies 12.34", d4_str_eq(a2, s2_cmp)));
+  assert(((void) "Stringifies 0.3", d4_str_eq(a3, s3_cmp)));
+  assert(((void) "Stringifies -2.5", d4_str_eq(a4, s4_cmp)));
+  assert(((void) "Stringifies 0.0000001", d4_str_eq(a5, s5_cmp)));
+  assert(((void) "Stringifies 16777216.0", d4_str_eq(a6, s6_cmp)));
+  assert(((void) "Stringifies -0.0", d4_str_eq(a7, s7_cmp)));
 
   d4_str_free(s1_cmp);
   d4_str_free(s2_cmp);
+  d4_str_free(s3_cmp);
+  d4_str_free(s4_cmp);
+  d4_str_free(s5_cmp);
+  d4_str_free(s6_cmp);
+  d4_str_free(s7_cmp);
 
   d4_str_free(a1);
   d4_str_free(a2);
+  d4_str_free(a3);
+  d4_str_free(a4);
+  d4_str_free(a5);
+  d4_str_free(a6);
+  d4_str_free(a7);
 }
 
 static void test_f64_str (void) {
   d4_str_t a1 = d4_f64_str(0.0);
   d4_str_t a2 = d4_f64_str(12.34);
+  d4_str_t a3 = d4_f64_str(0.1);
+  d4_str_t a4 = d4_f64_str(-2.5);
+  d4_str_t a5 = d4_f64_str(1e-7);
+  d4_str_t a6 = d4_f64_str(1e20);
+  d4_str_t a7 = d4_f64_str(-0.0);
+  d4_str_t a8 = d4_f64_str(0.1 + 0.2);
 
   d4_str_t s1_cmp = d4_str_alloc(L"0.0");
   d4_str_t s2_cmp = d4_str_alloc(L"12.34");
+  d4_str_t s3_cmp = d4_str_alloc(L"0.1");
+  d4_str_t s4_cmp = d4_str_alloc(L"-2.5");
+  d4_str_t s5_cmp = d4_str_alloc(L"0.0000001");
+  d4_str_t s6_cmp = d4_str_alloc(L"100000000000000000000.0");
+  d4_str_t s7_cmp = d4_str_alloc(L"-0.0");
+  d4_str_t s8_cmp = d4_str_alloc(L"0.30000000000000004");
 
   assert(((void) "Stringifies 0.0", d4_str_eq(a1, s1_cmp)));
   assert(((void) "Stringifies 12.34", d4_str_eq(a2, s2_cmp)));
+  assert(((void) "Stringifies 0.1", d4_str_eq(a3, s3_cmp)));
+  assert(((void) "Stringifies -2.5", d4_str_eq(a4, s4_cmp)));
+  assert(((void) "Stringifies 0.0000001", d4_str_eq(a5, s5_cmp)));
+  assert(((void) "Stringifies 100000000000000000000.0", d4_str_eq(a6, s6_cmp)));
+  assert(((void) "Stringifies -0.0", d4_str_eq(a7, s7_cmp)));
+  assert(((void) "Stringifies 0.30000000000000004", d4_str_eq(a8, s8_cmp)));
 
   d4_str_free(s1_cmp);
   d4_str_free(s2_cmp);
+  d4_str_free(s3_cmp);
+  d4_str_free(s4_cmp);
+  d4_str_free(s5_cmp);
+  d4_str_free(s6_cmp);
+  d4_str_free(s7_cmp);
+  d4_str_free(s8_cmp);
 
   d4_str_free(a1);
   d4_str_free(a2);
+  d4_str_free(a3);
+  d4_str_free(a4);
+  d4_str_free(a5);
+  d4_str_free(a6);
+  d4_str_free(a7);
+  d4_str_free(a8);
 }
 
 static void test_float_str (void) {
   d4_str_t a1 = d4_float_str(0.0);
   d4_str_t a2 = d4_float_str(12.34);
+  d4_str_t a3 = d4_float_str(0.1);
+  d4_str_t a4 = d4_float_str(-2.5);
+  d4_str_t a5 = d4_float_str(1e-7);
+  d4_str_t a6 = d4_float_str(1e20);
+  d4_str_t a7 = d4_float_str(-0.0);
+  d4_str_t a8 = d4_float_str(0.1 + 0.2);
 
   d4_str_t s1_cmp = d4_str_alloc(L"0.0");
   d4_str_t s2_cmp = d4_str_alloc(L"12.34");
+  d4_str_t s3_cmp = d4_str_alloc(L"0.1");
+  d4_str_t s4_cmp = d4_str_alloc(L"-2.5");
+  d4_str_t s5_cmp = d4_str_alloc(L"0.0000001");
+  d4_str_t s6_cmp = d4_str_alloc(L"100000000000000000000.0");
+  d4_str_t s7_cmp = d4_str_alloc(L"-0.0");
+  d4_str_t s8_cmp = d4_str_alloc(L"0.30000000000000004");
 
   assert(((void) "Stringifies 0.0", d4_str_eq(a1, s1_cmp)));
   assert(((void) "Stringifies 12.34", d4_str_eq(a2, s2_cmp)));
+  assert(((void) "Stringifies 0.1", d4_str_eq(a3, s3_cmp)));
+  assert(((void) "Stringifies -2.5", d4_str_eq(a4, s4_cmp)));
+  assert(((void) "Stringifies 0.0000001", d4_str_eq(a5, s5_cmp)));
+  assert(((void) "Stringifies 100000000000000000000.0", d4_str_eq(a6, s6_cmp)));
+  assert(((void) "Stringifies -0.0", d4_str_eq(a7, s7_cmp)));
+  assert(((void) "Stringifies 0.30000000000000004", d4_str_eq(a8, s8_cmp)));
 
   d4_str_free(s1_cmp);
   d4_str_free(s2_cmp);
+  d4_str_free(s3_cmp);
+  d4_str_free(s4_cmp);
+  d4_str_free(s5_cmp);
+  d4_str_free(s6_cmp);
+  d4_str_free(s7_cmp);
+  d4_str_free(s8_cmp);
 
   d4_str_free(a1);
   d4_str_free(a2);
+  d4_str_free(a3);
+  d4_str_free(a4);
+  d4_str_free(a5);
+  d4_str_free(a6);
+  d4_str_free(a7);
+  d4_str_free(a8);
 }
 
 static void test_i8_str (void) {
@@ -106,22 +192,76 @@ static void test_i32_str (void) {
   d4_str_t a1 = d4_i32_str(INT32_MIN);
   d4_str_t a2 = d4_i32_str(0);
   d4_str_t a3 = d4_i32_str(INT32_MAX);
+  d4_str_t a4 = d4_i32_str(-129);
+  d4_str_t a5 = d4_i32_str(-128);
+  d4_str_t a6 = d4_i32_str(99);
+  d4_str_t a7 = d4_i32_str(100);
+  d4_str_t a8 = d4_i32_str(1023);
+  d4_str_t a9 = d4_i32_str(1024);
 
   d4_str_t s1_cmp = d4_str_alloc(L"-2147483648");
   d4_str_t s2_cmp = d4_str_alloc(L"0");
   d4_str_t s3_cmp = d4_str_alloc(L"2147483647");
+  d4_str_t s4_cmp = d4_str_alloc(L"-129");
+  d4_str_t s5_cmp = d4_str_alloc(L"-128");
+  d4_str_t s6_cmp = d4_str_alloc(L"99");
+  d4_str_t s7_cmp = d4_str_alloc(L"100");
+  d4_str_t s8_cmp = d4_str_alloc(L"1023");
+  d4_str_t s9_cmp = d4_str_alloc(L"1024");
 
   assert(((void) "Stringifies -2147483648", d4_str_eq(a1, s1_cmp)));
   assert(((void) "Stringifies 0", d4_str_eq(a2, s2_cmp)));
   assert(((void) "Stringifies 2147483647", d4_str_eq(a3, s3_cmp)));
+  assert(((void) "Stringifies -129", d4_str_eq(a4, s4_cmp)));
+  assert(((void) "Stringifies -128", d4_str_eq(a5, s5_cmp)));
+  assert(((void) "Stringifies 99", d4_str_eq(a6, s6_cmp)));
+  assert(((void) "Stringifies 100", d4_str_eq(a7, s7_cmp)));
+  assert(((void) "Stringifies 1023", d4_str_eq(a8, s8_cmp)));
+  assert(((void) "Stringifies 1024", d4_str_eq(a9, s9_cmp)));
+  assert(((void) "Serves small integers from static table", a5.is_static && a8.is_static && !a4.is_static && !a9.is_static));
 
   d4_str_free(s1_cmp);
   d4_str_free(s2_cmp);
   d4_str_free(s3_cmp);
+  d4_str_free(s4_cmp);
+  d4_str_free(s5_cmp);
+  d4_str_free(s6_cmp);
+  d4_str_free(s7_cmp);
+  d4_str_free(s8_cmp);
+  d4_str_free(s9_cmp);
 
   d4_str_free(a1);
   d4_str_free(a2);
   d4_str_free(a3);
+  d4_str_free(a4);
+  d4_str_free(a5);
+  d4_str_free(a6);
+  d4_str_free(a7);
+  d4_str_free(a8);
+  d4_str_free(a9);
+}
+
+static void test_i32_str_detach (void) {
+  d4_str_t a1 = d4_i32_str(5);
+  d4_str_t a2;
+
+  d4_str_t s1_cmp = d4_str_alloc(L"5");
+  d4_str_t s2_cmp = d4_str_alloc(L"9");
+
+  ASSERT_NO_THROW(AT1, {
+    *d4_str_atMut(&d4_err_state, 0, 0, &a1, 0) = L'9';
+  });
+
+  a2 = d4_i32_str(5);
+
+  assert(((void) "Modifies detached string", d4_str_eq(a1, s2_cmp) && !a1.is_static));
+  assert(((void) "Doesn't modify static table", d4_str_eq(a2, s1_cmp)));
+
+  d4_str_free(s1_cmp);
+  d4_str_free(s2_cmp);
+
+  d4_str_free(a1);
+  d4_str_free(a2);
 }
 
 static void test_i64_str (void) {
@@ -227,35 +367,55 @@ static void test_u16_str (void) {
 static void test_u32_str (void) {
   d4_str_t a1 = d4_u32_str(0);
   d4_str_t a2 = d4_u32_str(UINT32_MAX);
+  d4_str_t a3 = d4_u32_str(1023);
+  d4_str_t a4 = d4_u32_str(1024);
 
   d4_str_t s1_cmp = d4_str_alloc(L"0");
   d4_str_t s2_cmp = d4_str_alloc(L"4294967295");
+  d4_str_t s3_cmp = d4_str_alloc(L"1023");
+  d4_str_t s4_cmp = d4_str_alloc(L"1024");
 
   assert(((void) "Stringifies 0", d4_str_eq(a1, s1_cmp)));
   assert(((void) "Stringifies 4294967295", d4_str_eq(a2, s2_cmp)));
+  assert(((void) "Stringifies 1023", d4_str_eq(a3, s3_cmp)));
+  assert(((void) "Stringifies 1024", d4_str_eq(a4, s4_cmp)));
 
   d4_str_free(s1_cmp);
   d4_str_free(s2_cmp);
+  d4_str_free(s3_cmp);
+  d4_str_free(s4_cmp);
 
   d4_str_free(a1);
   d4_str_free(a2);
+  d4_str_free(a3);
+  d4_str_free(a4);
 }
 
 static void test_u64_str (void) {
   d4_str_t a1 = d4_u64_str(0);
   d4_str_t a2 = d4_u64_str(UINT64_MAX);
+  d4_str_t a3 = d4_u64_str(UINT64_C(10000000000000000000));
+  d4_str_t a4 = d4_u64_str(UINT64_C(9999999999999999999));
 
   d4_str_t s1_cmp = d4_str_alloc(L"0");
   d4_str_t s2_cmp = d4_str_alloc(L"18446744073709551615");
+  d4_str_t s3_cmp = d4_str_alloc(L"10000000000000000000");
+  d4_str_t s4_cmp = d4_str_alloc(L"9999999999999999999");
 
   assert(((void) "Stringifies 0", d4_str_eq(a1, s1_cmp)));
   assert(((void) "Stringifies 18446744073709551615", d4_str_eq(a2, s2_cmp)));
+  assert(((void) "Stringifies 10000000000000000000", d4_str_eq(a3, s3_cmp)));
+  assert(((void) "Stringifies 9999999999999999999", d4_str_eq(a4, s4_cmp)));
 
   d4_str_free(s1_cmp);
   d4_str_free(s2_cmp);
+  d4_str_free(s3_cmp);
+  d4_str_free(s4_cmp);
 
   d4_str_free(a1);
   d4_str_free(a2);
+  d4_str_free(a3);
+  d4_str_free(a4);
 }
 
 static void test_usize_str (void) {
@@ -282,6 +442,7 @@ int main (void) {
   test_i8_str();
   test_i16_str();
   test_i32_str();
+  test_i32_str_detach();
   test_i64_str();
   test_int_str();
   test_isize_str();
@@ -18,6 +18,8 @@ static void test_rune_isDigit (void) {
   assert(((void) "Checks '@'", !d4_rune_isDigit(L'@')));
   assert(((void) "Checks '0'", d4_rune_isDigit(L'0')));
   assert(((void) "Checks '9'", d4_rune_isDigit(L'9')));
+  assert(((void) "Checks Arabic-Indic '3'", d4_rune_isDigit(L'\u0663')));
+  assert(((void) "Checks superscript '2'", !d4_rune_isDigit(L'\u00B2')));
 }
 
 static void test_rune_isLetter (void) {
@@ -26,6 +28,9 @@ static void test_rune_isLetter (void) {
   assert(((void) "Checks '@'", !d4_rune_isLetter(L'@')));
   assert(((void) "Checks '0'", !d4_rune_isLetter(L'0')));
   assert(((void) "Checks '9'", !d4_rune_isLetter(L'9')));
+  assert(((void) "Checks 'e' with acute", d4_rune_isLetter(L'\u00E9')));
+  assert(((void) "Checks CJK ideograph", d4_rune_isLetter(L'\u4E2D')));
+  assert(((void) "Checks multiplication sign", !d4_rune_isLetter(L'\u00D7')));
 }
 
 static void test_rune_isLetterOrDigit (void) {
@@ -34,6 +39,9 @@ static void test_rune_isLetterOrDigit (void) {
   assert(((void) "Checks '@'", !d4_rune_isLetterOrDigit(L'@')));
   assert(((void) "Checks '0'", d4_rune_isLetterOrDigit(L'0')));
   assert(((void) "Checks '9'", d4_rune_isLetterOrDigit(L'9')));
+  assert(((void) "Checks Cyrillic 'd'", d4_rune_isLetterOrDigit(L'\u0434')));
+  assert(((void) "Checks Devanagari '7'", d4_rune_isLetterOrDigit(L'\u096D')));
+  assert(((void) "Checks em dash", !d4_rune_isLetterOrDigit(L'\u2014')));
 }
 
 static void test_rune_isLower (void) {
@@ -42,6 +50,8 @@ static void test_rune_isLower (void) {
   assert(((void) "Checks '@'", !d4_rune_isLower(L'@')));
   assert(((void) "Checks '0'", !d4_rune_isLower(L'0')));
   assert(((void) "Checks '9'", !d4_rune_isLower(L'9')));
+  assert(((void) "Checks 'omega'", d4_rune_isLower(L'\u03C9')));
+  assert(((void) "Checks 'Omega'", !d4_rune_isLower(L'\u03A9')));
 }
 
 static void test_rune_isUpper (void) {
@@ -50,6 +60,9 @@ static void test_rune_isUpper (void) {
   assert(((void) "Checks '@'", !d4_rune_isUpper(L'@')));
   assert(((void) "Checks '0'", !d4_rune_isUpper(L'0')));
   assert(((void) "Checks '9'", !d4_rune_isUpper(L'9')));
+  assert(((void) "Checks 'Omega'", d4_rune_isUpper(L'\u03A9')));
+  assert(((void) "Checks 'omega'", !d4_rune_isUpper(L'\u03C9')));
+  assert(((void) "Checks titlecase 'Dz'", !d4_rune_isUpper(L'\u01C5')));
 }
 
 static void test_rune_isWhitespace (void) {
@@ -58,6 +71,11 @@ static void test_rune_isWhitespace (void) {
   assert(((void) "Checks '@'", !d4_rune_isWhitespace(L'@')));
   assert(((void) "Checks '0'", !d4_rune_isWhitespace(L'0')));
   assert(((void) "Checks '9'", !d4_rune_isWhitespace(L'9')));
+  assert(((void) "Checks ' '", d4_rune_isWhitespace(L' ')));
+  assert(((void) "Checks '\\t'", d4_rune_isWhitespace(L'\t')));
+  assert(((void) "Checks no-break space", d4_rune_isWhitespace(L'\u00A0')));
+  assert(((void) "Checks ideographic space", d4_rune_isWhitespace(L'\u3000')));
+  assert(((void) "Checks zero width space", !d4_rune_isWhitespace(L'\u200B')));
 }
 
 static void test_rune_lower (void) {
@@ -66,6 +84,14 @@ static void test_rune_lower (void) {
   assert(((void) "Transforms into lowercase '@'", d4_rune_lower(L'@') == L'@'));
   assert(((void) "Transforms into lowercase '0'", d4_rune_lower(L'0') == L'0'));
   assert(((void) "Transforms into lowercase '9'", d4_rune_lower(L'9') == L'9'));
+  assert(((void) "Transforms into lowercase 'E' with acute", d4_rune_lower(L'\u00C9') == L'\u00E9'));
+  assert(((void) "Transforms into lowercase 'Omega'", d4_rune_lower(L'\u03A9') == L'\u03C9'));
+  assert(((void) "Transforms into lowercase 'I' with dot", d4_rune_lower(L'\u0130') == L'i'));
+  assert(((void) "Transforms into lowercase 'sharp s'", d4_rune_lower(L'\u00DF') == L'\u00DF'));
+
+  #if WCHAR_MAX > 0xFFFF
+    assert(((void) "Transforms into lowercase 'Deseret long I'", d4_rune_lower((wchar_t) 0x10400) == (wchar_t) 0x10428));
+  #endif
 }
 
 static void test_rune_repeat (void) {
@@ -118,6 +144,14 @@ static void test_rune_upper (void) {
   assert(((void) "Transforms into uppercase '@'", d4_rune_upper(L'@') == L'@'));
   assert(((void) "Transforms into uppercase '0'", d4_rune_upper(L'0') == L'0'));
   assert(((void) "Transforms into uppercase '9'", d4_rune_upper(L'9') == L'9'));
+  assert(((void) "Transforms into uppercase 'e' with acute", d4_rune_upper(L'\u00E9') == L'\u00C9'));
+  assert(((void) "Transforms into uppercase 'y' with diaeresis", d4_rune_upper(L'\u00FF') == L'\u0178'));
+  assert(((void) "Transforms into uppercase 'omega'", d4_rune_upper(L'\u03C9') == L'\u03A9'));
+  assert(((void) "Transforms into uppercase 'sharp s'", d4_rune_upper(L'\u00DF') == L'\u00DF'));
+
+  #if WCHAR_MAX > 0xFFFF
+    assert(((void) "Transforms into uppercase 'Deseret long i'", d4_rune_upper((wchar_t) 0x10428) == (wchar_t) 0x10400));
+  #endif
 }
 
 int main (void) {
@@ -4,15 +4,53 @@
  */
 
 #include <assert.h>
+#include <inttypes.h>
+#include "../src/char.h"
+#include "../src/rune.h"
 #include "../src/string.h"
 #include "utils.h"
 
 static void test_string_snwprintf (void) {
-  // todo
+  assert(((void) "Measures empty", snwprintf(L"") == 0));
+  assert(((void) "Measures with format", snwprintf(L"%ls:%d", L"test", -10) == 8));
+  assert(((void) "Measures with libc format", snwprintf(L"%5d", 10) == 5));
+}
+
+static int test_string_vsnwprintf_call (const wchar_t *fmt, ...) {
+  va_list args;
+  int result;
+
+  va_start(args, fmt);
+  result = vsnwprintf(fmt, args);
+  va_end(args);
+
+  return result;
 }
 
 static void test_string_vsnwprintf (void) {
-  // todo
+  assert(((void) "Measures with format", test_string_vsnwprintf_call(L"%zu %f", (size_t) 100, 1.5) == 12));
+  assert(((void) "Measures with libc format", test_string_vsnwprintf_call(L"%x", 255) == 2));
+}
+
+static void test_string_arr_sortAsc (void) {
+  d4_str_t s1 = d4_str_alloc(L"pear");
+  d4_str_t s2 = d4_str_alloc(L"apple");
+  d4_str_t s3 = d4_str_alloc(L"app");
+  d4_str_t s4 = d4_str_alloc(L"Zoo");
+  d4_arr_str_t a1 = d4_arr_str_alloc(4, s1, s2, s3, s4);
+  d4_arr_str_t a2 = d4_arr_str_alloc(0);
+
+  assert(((void) "Returns self", d4_arr_str_sortAsc(&a1) == &a1));
+  assert(((void) "Sorts by character codes", d4_str_eq(a1.data[0], s4) && d4_str_eq(a1.data[1], s3)));
+  assert(((void) "Sorts prefix first", d4_str_eq(a1.data[2], s2) && d4_str_eq(a1.data[3], s1)));
+  assert(((void) "Sorts empty", d4_arr_str_sortAsc(&a2)->len == 0));
+
+  d4_arr_str_free(a1);
+  d4_arr_str_free(a2);
+  d4_str_free(s1);
+  d4_str_free(s2);
+  d4_str_free(s3);
+  d4_str_free(s4);
 }
 
 static void test_string_alloc (void) {
@@ -20,6 +58,10 @@ static void test_string_alloc (void) {
   d4_str_t s2 = d4_str_alloc(L"Test");
   d4_str_t s3 = d4_str_alloc(L"%d", 10);
   d4_str_t s4 = d4_str_alloc(L"10");
+  d4_str_t s5 = d4_str_alloc(L"%ls|%.*ls|%" PRId64 L"|%" PRIu8 L"|%zu|%f|%%", L"a", 2, L"bcd", INT64_MIN, (uint8_t) 255, (size_t) 7, -0.5);
+  d4_str_t s6 = d4_str_alloc(L"%3d|%x", 1, 255);
+  d4_str_t s7 = d4_str_alloc(L"%ls", L"a");
+  d4_str_t s8 = d4_str_alloc(L"%ls|%.*ls|%.*ls|", (const wchar_t *) NULL, 6, (const wchar_t *) NULL, 5, (const wchar_t *) NULL);
 
   assert(((void) "Allocates empty", s1.data == NULL));
   assert(((void) "Allocates empty", s1.len == 0));
@@ -29,11 +71,19 @@ static void test_string_alloc (void) {
 
   assert(((void) "Allocates with format", d4_str_eq(s3, s4)));
   assert(((void) "Allocates with format", s3.len == 2));
+  assert(((void) "Allocates with all formats", wcscmp(s5.data, L"a|bc|-9223372036854775808|255|7|-0.500000|%") == 0));
+  assert(((void) "Allocates with libc format", wcscmp(s6.data, L"  1|ff") == 0));
+  assert(((void) "Allocates single character without allocation", s7.is_static && wcscmp(s7.data, L"a") == 0));
+  assert(((void) "Allocates with null string", wcscmp(s8.data, L"(null)|(null)||") == 0));
 
   d4_str_free(s1);
   d4_str_free(s2);
   d4_str_free(s3);
   d4_str_free(s4);
+  d4_str_free(s5);
+  d4_str_free(s6);
+  d4_str_free(s7);
+  d4_str_free(s8);
 }
 
 static void test_string_calloc (void) {
@@ -59,6 +109,39 @@ static void test_string_calloc (void) {
   d4_str_free(s6);
 }
 
+static void test_string_appendMove (void) {
+  d4_str_t s1 = d4_str_alloc(L"Hello");
+  d4_str_t s2 = d4_str_alloc(L", World");
+  d4_str_t s3 = d4_str_copy(s1);
+  d4_str_t s4 = d4_str_empty_val;
+  wchar_t *d;
+
+  s1 = d4_str_appendMove(s1, s2);
+  assert(((void) "Appends to shared", wcscmp(s1.data, L"Hello, World") == 0 && wcscmp(s3.data, L"Hello") == 0));
+
+  d4_str_free(s3);
+  s1 = d4_str_appendMove(s1, s2);
+  s1 = d4_str_appendMove(s1, d4_str_empty_val);
+  assert(((void) "Appends to unique", wcscmp(s1.data, L"Hello, World, World") == 0 && s1.len == 19));
+
+  d = s1.data;
+  s1 = d4_str_appendMove(s1, (d4_str_view_t) {L"!", 1, true, false});
+  assert(((void) "Reuses spare capacity", s1.data == d && wcscmp(s1.data, L"Hello, World, World!") == 0));
+
+  s1 = d4_str_appendMove(s1, (d4_str_view_t) {s1.data, 5, true, false});
+  assert(((void) "Appends own data", wcscmp(s1.data, L"Hello, World, World!Hello") == 0));
+
+  for (int32_t i = 0; i < 100; i++) {
+    s4 = d4_str_appendMove(s4, s2);
+  }
+
+  assert(((void) "Appends in a loop", s4.len == 700 && wcsncmp(&s4.data[693], L", World", 7) == 0 && s4.data[700] == L'\0'));
+
+  d4_str_free(s1);
+  d4_str_free(s2);
+  d4_str_free(s4);
+}
+
 static void test_string_at (void) {
   d4_str_t s1 = d4_str_empty_val;
   d4_str_t s2 = d4_str_alloc(L"1234");
@@ -88,6 +171,223 @@ static void test_string_at (void) {
   d4_str_free(s2);
 }
 
+static void test_string_atMut (void) {
+  d4_str_t s1 = d4_str_alloc(L"hello world");
+  d4_str_t s2 = d4_str_copy(s1);
+  d4_str_t s3 = d4_str_intern(s1);
+  d4_str_t s4 = d4_str_intern(s1);
+  d4_str_view_t v1 = d4_str_sliceView(s1, 1, 6, 0, 0);
+  d4_str_t r1 = d4_str_alloc(L"hello world");
+  d4_str_t r2 = d4_str_alloc(L"Jello world");
+
+  ASSERT_THROW_WITH_MESSAGE(AT_MUT1, {
+    d4_str_atMut(&d4_err_state, 0, 0, &s1, 11);
+  }, L"index 11 out of string bounds");
+
+  ASSERT_THROW_WITH_MESSAGE(AT_MUT2, {
+    d4_str_atMut(&d4_err_state, 0, 0, &v1, 0);
+  }, L"string view can't be modified");
+
+  ASSERT_NO_THROW(AT_MUT3, {
+    assert(((void) "Reads copy without detaching", d4_str_at(&d4_err_state, 0, 0, s2, 0) == s1.data));
+    *d4_str_atMut(&d4_err_state, 0, 0, &s2, 0) = L'J';
+    *d4_str_atMut(&d4_err_state, 0, 0, &s4, -11) = L'J';
+  });
+
+  assert(((void) "Detaches copy of shared string", s2.data != s1.data && d4_str_eq(s2, r2)));
+  assert(((void) "Doesn't modify original of shared string", d4_str_eq(s1, r1)));
+  assert(((void) "Detaches interned string", s4.data != s3.data && d4_str_eq(s4, r2) && d4_str_eq(s3, r1)));
+  assert(((void) "Doesn't modify interned string", d4_str_eq(d4_str_intern(r1), r1)));
+  assert(((void) "Leaves view borrowed", v1.is_static && v1.data == &s1.data[6]));
+
+  ASSERT_NO_THROW(AT_MUT4, {
+    assert(((void) "Doesn't detach unique string", d4_str_atMut(&d4_err_state, 0, 0, &s1, 0) == s1.data));
+  });
+
+  d4_str_free(s1);
+  d4_str_free(s2);
+  d4_str_free(s3);
+  d4_str_free(s4);
+  d4_str_free(r1);
+  d4_str_free(r2);
+}
+
+static bool test_string_isVowel (wchar_t c) {
+  return c == L'a' || c == L'e' || c == L'i' || c == L'o' || c == L'u';
+}
+
+static void test_string_allOf (void) {
+  d4_str_t s1 = d4_str_empty_val;
+  d4_str_t s2 = d4_str_alloc(L"0123456789012345678901234567890123456789");
+  d4_str_t s3 = d4_str_alloc(L"01234567890123456789x");
+  d4_str_t s4 = d4_str_alloc(L"\u00C9cole \u0434\u043E\u043C Hello World");
+  d4_str_t s5 = d4_str_alloc(L"aeiouaeiou");
+
+  assert(((void) "Checks empty", d4_str_allOf(s1, d4_rune_isDigit)));
+  assert(((void) "Checks digits", d4_str_allOf(s2, d4_rune_isDigit)));
+  assert(((void) "Checks digits with letter", !d4_str_allOf(s3, d4_rune_isDigit)));
+  assert(((void) "Checks letters or digits", d4_str_allOf(s3, d4_rune_isLetterOrDigit)));
+  assert(((void) "Checks non-ASCII with space", !d4_str_allOf(s4, d4_rune_isLetter)));
+  assert(((void) "Checks custom predicate", d4_str_allOf(s5, test_string_isVowel)));
+  assert(((void) "Checks custom predicate failing", !d4_str_allOf(s3, test_string_isVowel)));
+
+  d4_str_free(s1);
+  d4_str_free(s2);
+  d4_str_free(s3);
+  d4_str_free(s4);
+  d4_str_free(s5);
+}
+
+static void test_string_builder_alloc (void) {
+  d4_str_builder_t b1 = d4_str_builder_alloc(0);
+  d4_str_builder_t b2 = d4_str_builder_alloc(10);
+
+  assert(((void) "Allocates empty builder", b1.data == NULL && b1.len == 0 && b1.cap == 0));
+  assert(((void) "Allocates builder with capacity", b2.data != NULL && b2.len == 0 && b2.cap == 10));
+
+  d4_str_builder_free(b1);
+  d4_str_builder_free(b2);
+}
+
+static void test_string_builder_appendFloat (void) {
+  d4_str_builder_t b1 = d4_str_builder_alloc(0);
+  d4_str_t s1;
+
+  d4_str_builder_appendFloat(&b1, 3.14);
+  d4_str_builder_appendWchar(&b1, L' ');
+  d4_str_builder_appendFloat(&b1, -2);
+  s1 = d4_str_builder_finish(&b1);
+
+  assert(((void) "Appends floats", wcscmp(s1.data, L"3.14 -2.0") == 0));
+  d4_str_free(s1);
+}
+
+static void test_string_builder_appendInt (void) {
+  d4_str_builder_t b1 = d4_str_builder_alloc(0);
+  d4_str_t s1;
+
+  d4_str_builder_appendInt(&b1, 0);
+  d4_str_builder_appendWchar(&b1, L' ');
+  d4_str_builder_appendInt(&b1, 1234567890);
+  d4_str_builder_appendWchar(&b1, L' ');
+  d4_str_builder_appendInt(&b1, INT64_MIN);
+  d4_str_builder_appendWchar(&b1, L' ');
+  d4_str_builder_appendInt(&b1, INT64_MAX);
+  s1 = d4_str_builder_finish(&b1);
+
+  assert(((void) "Appends integers", wcscmp(s1.data, L"0 1234567890 -9223372036854775808 9223372036854775807") == 0));
+  d4_str_free(s1);
+}
+
+static void test_string_builder_appendStr (void) {
+  d4_str_builder_t b1 = d4_str_builder_alloc(0);
+  d4_str_t s1 = d4_str_alloc(L"Hello");
+  d4_str_t s2;
+
+  for (size_t i = 0; i < 100; i++) {
+    d4_str_builder_appendStr(&b1, s1);
+    d4_str_builder_appendStr(&b1, d4_str_empty_val);
+  }
+
+  s2 = d4_str_builder_finish(&b1);
+
+  assert(((void) "Appends strings", s2.len == 500 && wcsncmp(s2.data, L"HelloHello", 10) == 0));
+  assert(((void) "Terminates result", s2.data[s2.len] == L'\0'));
+
+  d4_str_free(s1);
+  d4_str_free(s2);
+}
+
+static void test_string_builder_appendWchar (void) {
+  d4_str_builder_t b1 = d4_str_builder_alloc(1);
+  d4_str_t s1;
+
+  d4_str_builder_appendWchar(&b1, L'a');
+  d4_str_builder_appendWchar(&b1, L'\u0434');
+  d4_str_builder_appendWchar(&b1, L'c');
+  s1 = d4_str_builder_finish(&b1);
+
+  assert(((void) "Appends characters", wcscmp(s1.data, L"a\u0434c") == 0));
+  d4_str_free(s1);
+}
+
+static void test_string_builder_finish (void) {
+  d4_str_builder_t b1 = d4_str_builder_alloc(0);
+  d4_str_builder_t b2 = d4_str_builder_alloc(10);
+  d4_str_t s1 = d4_str_builder_finish(&b1);
+  d4_str_t s2 = d4_str_builder_finish(&b2);
+  d4_str_t s3;
+
+  d4_str_builder_appendWchar(&b2, L'a');
+  s3 = d4_str_builder_finish(&b2);
+
+  assert(((void) "Finishes empty builder", d4_str_eq(s1, d4_str_empty_val)));
+  assert(((void) "Finishes builder with capacity", d4_str_eq(s2, d4_str_empty_val)));
+  assert(((void) "Reuses finished builder", wcscmp(s3.data, L"a") == 0 && b2.data == NULL));
+
+  d4_str_free(s1);
+  d4_str_free(s2);
+  d4_str_free(s3);
+}
+
+static void test_string_builder_free (void) {
+  d4_str_builder_t b1 = d4_str_builder_alloc(0);
+  d4_str_builder_t b2 = d4_str_builder_alloc(0);
+
+  d4_str_builder_appendWchar(&b2, L'a');
+  d4_str_builder_free(b1);
+  d4_str_builder_free(b2);
+}
+
+static void test_string_cmp (void) {
+  d4_str_t s1 = d4_str_alloc(L"The quick brown fox jumps over the lazy dog");
+  d4_str_t s2 = d4_str_alloc(L"The quick brown fox jumps over the lazy cat");
+  d4_str_t s3 = d4_str_alloc(L"The quick brown fox jumps over the lazy dog");
+  d4_str_t s4 = d4_str_alloc(L"The quick brown fox");
+  d4_str_t s5 = d4_str_alloc(L"\u00E9");
+  d4_str_t s6 = d4_str_alloc(L"z");
+
+  assert(((void) "Compares equal", d4_str_cmp(s1, s3) == 0 && d4_str_cmp(s1, s1) == 0));
+  assert(((void) "Compares mismatch after vector block", d4_str_cmp(s1, s2) > 0 && d4_str_cmp(s2, s1) < 0));
+  assert(((void) "Compares prefix", d4_str_cmp(s4, s1) < 0 && d4_str_cmp(s1, s4) > 0));
+  assert(((void) "Compares empty", d4_str_cmp(d4_str_empty_val, d4_str_empty_val) == 0 && d4_str_cmp(d4_str_empty_val, s6) < 0));
+  assert(((void) "Compares by character codes", d4_str_cmp(s5, s6) > 0));
+
+  d4_str_free(s1);
+  d4_str_free(s2);
+  d4_str_free(s3);
+  d4_str_free(s4);
+  d4_str_free(s5);
+  d4_str_free(s6);
+}
+
+static void test_string_cmpIgnoreCase (void) {
+  d4_str_t s1 = d4_str_alloc(L"The quick brown fox jumps over the lazy dog");
+  d4_str_t s2 = d4_str_alloc(L"THE QUICK BROWN FOX JUMPS OVER THE LAZY CAT");
+  d4_str_t s3 = d4_str_alloc(L"THE QUICK BROWN FOX JUMPS OVER THE LAZY DOG");
+  d4_str_t s4 = d4_str_alloc(L"the quick brown FOX");
+  d4_str_t s5 = d4_str_alloc(L"\u00C9cole");
+  d4_str_t s6 = d4_str_alloc(L"\u00E9COLE");
+  d4_str_t s7 = d4_str_alloc(L"Z");
+  d4_str_t s8 = d4_str_alloc(L"a");
+
+  assert(((void) "Compares equal", d4_str_cmpIgnoreCase(s1, s3) == 0 && d4_str_cmpIgnoreCase(s1, s1) == 0));
+  assert(((void) "Compares mismatch after vector block", d4_str_cmpIgnoreCase(s1, s2) > 0 && d4_str_cmpIgnoreCase(s2, s1) < 0));
+  assert(((void) "Compares prefix", d4_str_cmpIgnoreCase(s4, s1) < 0 && d4_str_cmpIgnoreCase(s1, s4) > 0));
+  assert(((void) "Compares empty", d4_str_cmpIgnoreCase(d4_str_empty_val, d4_str_empty_val) == 0 && d4_str_cmpIgnoreCase(d4_str_empty_val, s7) < 0));
+  assert(((void) "Compares non-ASCII", d4_str_cmpIgnoreCase(s5, s6) == 0));
+  assert(((void) "Compares by folded character codes", d4_str_cmpIgnoreCase(s7, s8) > 0 && d4_str_cmp(s7, s8) < 0));
+
+  d4_str_free(s1);
+  d4_str_free(s2);
+  d4_str_free(s3);
+  d4_str_free(s4);
+  d4_str_free(s5);
+  d4_str_free(s6);
+  d4_str_free(s7);
+  d4_str_free(s8);
+}
+
 static void test_string_concat (void) {
   d4_str_t s1 = d4_str_empty_val;
   d4_str_t s2 = d4_str_alloc(L"hello");
@@ -122,6 +422,8 @@ static void test_string_contains (void) {
   d4_str_t s4 = d4_str_alloc(L"ell");
   d4_str_t s5 = d4_str_alloc(L"lo");
   d4_str_t s6 = d4_str_alloc(L"wor");
+  d4_str_t s7 = d4_str_alloc(L"hello hello hello hello hello hello hello hello world");
+  d4_str_t s8 = d4_str_alloc(L"hellp");
 
   assert(((void) "Empty contains itself", d4_str_contains(s1, s1)));
   assert(((void) "Empty doesn't contain non-empty", !d4_str_contains(s1, s4)));
@@ -130,6 +432,9 @@ static void test_string_contains (void) {
   assert(((void) "Non-empty contains other part 2", d4_str_contains(s2, s4)));
   assert(((void) "Non-empty contains other part 3", d4_str_contains(s2, s5)));
   assert(((void) "Non-empty doesn't contains other part", !d4_str_contains(s2, s6)));
+  assert(((void) "Non-empty doesn't contain string of same length", !d4_str_contains(s2, s8)));
+  assert(((void) "Long string contains other part", d4_str_contains(s7, s6)));
+  assert(((void) "Long string doesn't contain other part", !d4_str_contains(s7, s8)));
 
   d4_str_free(s1);
   d4_str_free(s2);
@@ -137,22 +442,52 @@ static void test_string_contains (void) {
   d4_str_free(s4);
   d4_str_free(s5);
   d4_str_free(s6);
+  d4_str_free(s7);
+  d4_str_free(s8);
 }
 
 static void test_string_copy (void) {
   d4_str_t s1 = d4_str_empty_val;
   d4_str_t s2 = d4_str_alloc(L"string");
+  d4_str_t s3 = d4_str_alloc(L"s");
 
   d4_str_t c1 = d4_str_copy(s1);
   d4_str_t c2 = d4_str_copy(s2);
+  d4_str_t c3 = d4_str_copy(s3);
 
   assert(((void) "Copies empty", d4_str_eq(c1, s1)));
   assert(((void) "Copies non-empty", d4_str_eq(c2, s2)));
+  assert(((void) "Copies single character", d4_str_eq(c3, s3)));
+  assert(((void) "Copies single character without allocation", c3.is_static && c3.data == s3.data));
+  assert(((void) "Copies shared string by reference", c2.is_shared && c2.data == s2.data));
 
   d4_str_free(c1);
   d4_str_free(c2);
+  d4_str_free(c3);
+  d4_str_free(s1);
+  d4_str_free(s2);
+  d4_str_free(s3);
+}
+
+static void test_string_countIf (void) {
+  d4_str_t s1 = d4_str_empty_val;
+  d4_str_t s2 = d4_str_alloc(L"The Quick Brown Fox Jumps Over 13 Lazy Dogs");
+  d4_str_t s3 = d4_str_alloc(L"\u00C9COLE \u0434\u043E\u043C \u0663\u3000 Hello World 2024");
+
+  assert(((void) "Counts in empty", d4_str_countIf(s1, d4_rune_isDigit) == 0));
+  assert(((void) "Counts digits", d4_str_countIf(s2, d4_rune_isDigit) == 2));
+  assert(((void) "Counts letters", d4_str_countIf(s2, d4_rune_isLetter) == 33));
+  assert(((void) "Counts uppercase", d4_str_countIf(s2, d4_rune_isUpper) == 8));
+  assert(((void) "Counts lowercase", d4_str_countIf(s2, d4_rune_isLower) == 25));
+  assert(((void) "Counts whitespaces", d4_str_countIf(s2, d4_rune_isWhitespace) == 8));
+  assert(((void) "Counts custom predicate", d4_str_countIf(s2, test_string_isVowel) == 9));
+  assert(((void) "Counts non-ASCII digits", d4_str_countIf(s3, d4_rune_isDigit) == 5));
+  assert(((void) "Counts non-ASCII uppercase", d4_str_countIf(s3, d4_rune_isUpper) == 7));
+  assert(((void) "Counts non-ASCII whitespaces", d4_str_countIf(s3, d4_rune_isWhitespace) == 6));
+
   d4_str_free(s1);
   d4_str_free(s2);
+  d4_str_free(s3);
 }
 
 static void test_string_empty (void) {
@@ -172,18 +507,67 @@ static void test_string_eq (void) {
   d4_str_t s3 = d4_str_alloc(L"string");
   d4_str_t s4 = d4_str_alloc(L"string");
   d4_str_t s5 = d4_str_alloc(L"non string");
+  d4_str_t s6 = d4_str_alloc(L"STRING");
+  d4_str_t s7 = d4_str_alloc(L"STR\u00CDNG");
+  d4_str_t l3 = d4_str_lower(s6);
+  d4_str_t l4 = d4_str_lower(s7);
 
   assert(((void) "Empty equals empty", d4_str_eq(s1, s2)));
   assert(((void) "Empty not equals empty", !d4_str_eq(s1, s3)));
   assert(((void) "Non-empty equals non-empty", d4_str_eq(s3, s4)));
   assert(((void) "Non-empty not equals empty", !d4_str_eq(s3, s1)));
   assert(((void) "Non-empty not equals non-empty", !d4_str_eq(s3, s5)));
+  assert(((void) "Non-empty not equals non-empty of other width", !d4_str_eq(l3, l4)));
+
+  d4_str_free(s1);
+  d4_str_free(s2);
+  d4_str_free(s3);
+  d4_str_free(s4);
+  d4_str_free(s5);
+  d4_str_free(s6);
+  d4_str_free(s7);
+  d4_str_free(l3);
+  d4_str_free(l4);
+}
+
+static void test_string_eqIgnoreCase (void) {
+  d4_str_t s1 = d4_str_alloc(L"Content-Type");
+  d4_str_t s2 = d4_str_alloc(L"content-TYPE");
+  d4_str_t s3 = d4_str_alloc(L"Content-Length");
+  d4_str_t s4 = d4_str_alloc(L"The Quick Brown Fox Jumps Over The Lazy Dog");
+  d4_str_t s5 = d4_str_alloc(L"tHE qUICK bROWN fOX jUMPS oVER tHE lAZY dOG");
+  d4_str_t s6 = d4_str_alloc(L"\u00C9COLE \u0394\u0399\u0391");
+  d4_str_t s7 = d4_str_alloc(L"\u00E9cole \u03B4\u03B9\u03B1");
+  d4_str_t s8 = d4_str_alloc(L"\u212Aelvin \u017Fun");
+  d4_str_t s9 = d4_str_alloc(L"kELVIN SUN");
+  d4_str_t s10 = d4_str_alloc(L"\u0130");
+  d4_str_t s11 = d4_str_alloc(L"i");
+  d4_str_t s12 = d4_str_alloc(L"[");
+  d4_str_t s13 = d4_str_alloc(L"{");
+
+  assert(((void) "Empty equals empty", d4_str_eqIgnoreCase(d4_str_empty_val, d4_str_empty_val)));
+  assert(((void) "Empty not equals non-empty", !d4_str_eqIgnoreCase(d4_str_empty_val, s1)));
+  assert(((void) "Equals ignoring case", d4_str_eqIgnoreCase(s1, s2) && d4_str_eqIgnoreCase(s2, s1)));
+  assert(((void) "Not equals of other length", !d4_str_eqIgnoreCase(s1, s3)));
+  assert(((void) "Equals ignoring case across vector blocks", d4_str_eqIgnoreCase(s4, s5)));
+  assert(((void) "Equals non-ASCII ignoring case", d4_str_eqIgnoreCase(s6, s7)));
+  assert(((void) "Equals characters folding into ASCII", d4_str_eqIgnoreCase(s8, s9)));
+  assert(((void) "Not equals dotted capital I", !d4_str_eqIgnoreCase(s10, s11)));
+  assert(((void) "Not equals non-letters", !d4_str_eqIgnoreCase(s12, s13)));
 
   d4_str_free(s1);
   d4_str_free(s2);
   d4_str_free(s3);
   d4_str_free(s4);
   d4_str_free(s5);
+  d4_str_free(s6);
+  d4_str_free(s7);
+  d4_str_free(s8);
+  d4_str_free(s9);
+  d4_str_free(s10);
+  d4_str_free(s11);
+  d4_str_free(s12);
+  d4_str_free(s13);
 }
 
 static void test_string_escape (void) {
@@ -241,6 +625,13 @@ static void test_string_find (void) {
   d4_str_t s5 = d4_str_alloc(L"tri");
   d4_str_t s6 = d4_str_alloc(L"ing");
   d4_str_t s7 = d4_str_alloc(L"g");
+  d4_str_t s8 = d4_str_alloc(L"aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaab");
+  d4_str_t s9 = d4_str_alloc(L"aab");
+  d4_str_t s10 = d4_str_alloc(L"aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaab");
+  d4_str_t s11 = d4_str_alloc(L"aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaac");
+  d4_str_t s12 = d4_str_alloc(L"the quick brown fox jumps over the lazy dog, the quick brown fox jumps over the lazy cat");
+  d4_str_t s13 = d4_str_alloc(L"the quick brown fox jumps over the lazy cat");
+  d4_str_t s14 = d4_str_alloc(L"lazy c");
 
   assert(((void) "Finds empty in empty", d4_str_find(s1, s1) == 0));
   assert(((void) "Finds empty in string", d4_str_find(s3, s1) == 0));
@@ -253,6 +644,50 @@ static void test_string_find (void) {
   assert(((void) "Finds string in the middle in string", d4_str_find(s3, s5) == 1));
   assert(((void) "Finds string in the back in string", d4_str_find(s3, s6) == 3));
   assert(((void) "Finds single character string in the back in string", d4_str_find(s3, s7) == 5));
+  assert(((void) "Finds short string in long string", d4_str_find(s8, s9) == 65));
+  assert(((void) "Finds long string in long string", d4_str_find(s8, s10) == 29));
+  assert(((void) "Doesn't find long string in long string", d4_str_find(s8, s11) == -1));
+  assert(((void) "Finds long string in the back in long string", d4_str_find(s12, s13) == 45));
+  assert(((void) "Finds short string in the back in long string", d4_str_find(s12, s14) == 80));
+
+  d4_str_free(s1);
+  d4_str_free(s2);
+  d4_str_free(s3);
+  d4_str_free(s4);
+  d4_str_free(s5);
+  d4_str_free(s6);
+  d4_str_free(s7);
+  d4_str_free(s8);
+  d4_str_free(s9);
+  d4_str_free(s10);
+  d4_str_free(s11);
+  d4_str_free(s12);
+  d4_str_free(s13);
+  d4_str_free(s14);
+}
+
+static void test_string_findIgnoreCase (void) {
+  d4_str_t s1 = d4_str_alloc(L"hello world");
+  d4_str_t s2 = d4_str_alloc(L"WORLD");
+  d4_str_t s3 = d4_str_alloc(L"Hello");
+  d4_str_t s4 = d4_str_alloc(L"worlds");
+  d4_str_t s5 = d4_str_alloc(L"the quick brown fox jumps over the lazy dog, THE QUICK BROWN FOX JUMPS OVER THE LAZY CAT");
+  d4_str_t s6 = d4_str_alloc(L"Lazy C");
+  d4_str_t s7 = d4_str_alloc(L"Stra\u00DFe \u00C9COLE \u212Aelvin");
+  d4_str_t s8 = d4_str_alloc(L"\u00E9cole");
+  d4_str_t s9 = d4_str_alloc(L"KELVIN");
+  d4_str_t s10 = d4_str_alloc(L"hello world hello world \u212A");
+  d4_str_t s11 = d4_str_alloc(L"k");
+
+  assert(((void) "Finds empty", d4_str_findIgnoreCase(s1, d4_str_empty_val) == 0));
+  assert(((void) "Doesn't find non-empty in empty", d4_str_findIgnoreCase(d4_str_empty_val, s2) == -1));
+  assert(((void) "Finds ignoring case", d4_str_findIgnoreCase(s1, s2) == 6));
+  assert(((void) "Finds in the front", d4_str_findIgnoreCase(s1, s3) == 0));
+  assert(((void) "Doesn't find longer", d4_str_findIgnoreCase(s1, s4) == -1));
+  assert(((void) "Finds after vector block", d4_str_findIgnoreCase(s5, s6) == 80));
+  assert(((void) "Finds non-ASCII", d4_str_findIgnoreCase(s7, s8) == 7));
+  assert(((void) "Finds characters folding into ASCII", d4_str_findIgnoreCase(s7, s9) == 13));
+  assert(((void) "Finds character folding into ASCII after vector block", d4_str_findIgnoreCase(s10, s11) == 24));
 
   d4_str_free(s1);
   d4_str_free(s2);
@@ -261,6 +696,10 @@ static void test_string_find (void) {
   d4_str_free(s5);
   d4_str_free(s6);
   d4_str_free(s7);
+  d4_str_free(s8);
+  d4_str_free(s9);
+  d4_str_free(s10);
+  d4_str_free(s11);
 }
 
 static void test_string_free (void) {
@@ -272,159 +711,1702 @@ static void test_string_free (void) {
 }
 
 static void test_string_ge (void) {
-  // todo
+  d4_str_t s1 = d4_str_alloc(L"abc");
+  d4_str_t s2 = d4_str_alloc(L"abd");
+  d4_str_t s3 = d4_str_alloc(L"ab");
+
+  assert(((void) "Checks equal", d4_str_ge(s1, s1)));
+  assert(((void) "Checks less", !d4_str_ge(s1, s2)));
+  assert(((void) "Checks greater", d4_str_ge(s2, s1)));
+  assert(((void) "Checks longer", d4_str_ge(s1, s3)));
+  assert(((void) "Checks shorter", !d4_str_ge(s3, s1)));
+  assert(((void) "Checks empty", d4_str_ge(s3, d4_str_empty_val) && d4_str_ge(d4_str_empty_val, d4_str_empty_val)));
+
+  d4_str_free(s1);
+  d4_str_free(s2);
+  d4_str_free(s3);
 }
 
 static void test_string_gt (void) {
-  // todo
-}
+  d4_str_t s1 = d4_str_alloc(L"abc");
+  d4_str_t s2 = d4_str_alloc(L"abd");
+  d4_str_t s3 = d4_str_alloc(L"ab");
 
-static void test_string_le (void) {
-  // todo
-}
+  assert(((void) "Checks equal", !d4_str_gt(s1, s1)));
+  assert(((void) "Checks less", !d4_str_gt(s1, s2)));
+  assert(((void) "Checks greater", d4_str_gt(s2, s1)));
+  assert(((void) "Checks longer", d4_str_gt(s1, s3)));
+  assert(((void) "Checks shorter", !d4_str_gt(s3, s1)));
+  assert(((void) "Checks empty", d4_str_gt(s3, d4_str_empty_val) && !d4_str_gt(d4_str_empty_val, s3)));
 
-static void test_string_lines (void) {
-  // todo
+  d4_str_free(s1);
+  d4_str_free(s2);
+  d4_str_free(s3);
 }
 
-static void test_string_lower (void) {
-  // todo
+static void test_string_hash (void) {
+  d4_str_t s1 = d4_str_empty_val;
+  d4_str_t s2 = d4_str_alloc(L"string");
+  d4_str_t s3 = d4_str_alloc(L"string");
+  d4_str_t s4 = d4_str_alloc(L"strinG");
+  d4_str_t s5 = d4_str_copy(s2);
+  d4_str_t s6 = d4_str_alloc(L"stRing");
+  d4_str_view_t v1 = (d4_str_view_t) {L"string", 6, true, false};
+  d4_arr_str_t a1 = d4_arr_str_alloc(3, s1, s2, s4);
+
+  assert(((void) "Hashes empty", d4_str_hash(s1) == 0xcbf29ce484222325));
+  assert(((void) "Hashes equal strings equally", d4_str_hash(s2) == d4_str_hash(s3)));
+  assert(((void) "Hashes view equally", d4_str_hash(v1) == d4_str_hash(s2)));
+  assert(((void) "Hashes different strings differently", d4_str_hash(s2) != d4_str_hash(s4)));
+  assert(((void) "Hashes copy equally", d4_str_hash(s5) == d4_str_hash(s2)));
+  assert(((void) "Compares strings with hashes", d4_str_eq(s2, s3) && !d4_str_eq(s2, s4)));
+  assert(((void) "Finds in array", d4_arr_str_contains(a1, s3) && d4_arr_str_contains(a1, v1)));
+  assert(((void) "Finds in array again", d4_arr_str_contains(a1, s3) && d4_arr_str_contains(a1, s1)));
+  assert(((void) "Doesn't find in array", !d4_arr_str_contains(a1, s6)));
+
+  d4_arr_str_free(a1);
+  d4_str_free(s1);
+  d4_str_free(s2);
+  d4_str_free(s3);
+  d4_str_free(s4);
+  d4_str_free(s5);
+  d4_str_free(s6);
 }
 
-static void test_string_lowerFirst (void) {
-  // todo
-}
+static void test_string_hash_mutate (void) {
+  d4_str_t s1 = d4_str_alloc(L"hello");
+  d4_str_t s2 = d4_str_alloc(L"jello");
+  d4_str_t s3 = d4_str_alloc(L"HELLO");
+  d4_str_t s4 = d4_str_alloc(L"hello");
+  size_t h1 = d4_str_hash(s1);
+  size_t h2 = d4_str_hash(s2);
+  size_t h3 = d4_str_hash(s3);
+  size_t h4 = d4_str_hash(s4);
+
+  ASSERT_NO_THROW(AT1, {
+    *d4_str_atMut(&d4_err_state, 0, 0, &s1, 0) = L'j';
+  });
 
-static void test_string_lt (void) {
-  // todo
-}
+  s3 = d4_str_lowerInPlace(s3);
 
-static void test_string_not (void) {
-  // todo
-}
+  assert(((void) "Hashes differ before modification", h1 != h2 && h3 != h4));
+  assert(((void) "Compares string modified through pointer", d4_str_eq(s1, s2) && d4_str_eq(s2, s1)));
+  assert(((void) "Rehashes string modified through pointer", d4_str_hash(s1) == h2));
+  assert(((void) "Compares string modified in place", d4_str_eq(s3, s4) && d4_str_eq(s4, s3)));
+  assert(((void) "Rehashes string modified in place", d4_str_hash(s3) == h4));
 
-static void test_string_quoted_escape (void) {
-  // todo
+  d4_str_free(s1);
+  d4_str_free(s2);
+  d4_str_free(s3);
+  d4_str_free(s4);
 }
 
-static void test_string_realloc (void) {
-  // todo
-}
+static void test_string_widen_mutate (void) {
+  d4_str_t s1 = d4_str_alloc(L"abc");
+  d4_str_t s2 = d4_str_alloc(L"\u00E9bc");
+  d4_str_t s3 = d4_str_alloc(L"\u00C9BC");
+  d4_str_t u1 = d4_str_upper(s1);
+  d4_str_t u2 = d4_str_upper(s2);
+  d4_str_t u3 = d4_str_upper(s3);
+  d4_str_t u4;
+
+  ASSERT_NO_THROW(AT1, {
+    *d4_str_atMut(&d4_err_state, 0, 0, &s1, 0) = L'\u00E9';
+  });
 
-static void test_string_replace (void) {
-  // todo
-}
+  u4 = d4_str_upper(s1);
 
-static void test_string_slice (void) {
-  // todo
-}
+  assert(((void) "Compares string widened through pointer", d4_str_eq(s1, s2) && d4_str_eq(s2, s1)));
+  assert(((void) "Maps case of string widened through pointer", d4_str_eq(u4, s3) && d4_str_eq(u4, u2)));
+  assert(((void) "Finds in string widened through pointer", d4_str_find(s1, s2) == 0));
 
-static void test_string_split (void) {
-  // todo
+  d4_str_free(s1);
+  d4_str_free(s2);
+  d4_str_free(s3);
+  d4_str_free(u1);
+  d4_str_free(u2);
+  d4_str_free(u3);
+  d4_str_free(u4);
 }
 
-static void test_string_toFloat (void) {
-  // todo
-}
+static void test_string_intern (void) {
+  d4_str_intern_stats_t stats1 = d4_str_intern_stats();
+  d4_str_t s1 = d4_str_alloc(L"string");
+  d4_str_t s2 = d4_str_alloc(L"string");
+  d4_str_t s3 = d4_str_alloc(L"another");
+
+  d4_str_t i1 = d4_str_intern(s1);
+  d4_str_t i2 = d4_str_intern(s2);
+  d4_str_t i3 = d4_str_intern(s3);
+  d4_str_t i4 = d4_str_intern(i1);
+  d4_str_t i5 = d4_str_intern(d4_str_empty_val);
+  d4_str_t c1 = d4_str_copy(i1);
+  d4_str_intern_stats_t stats2 = d4_str_intern_stats();
+
+  assert(((void) "Interns equal strings into one buffer", i1.data == i2.data && i1.data != s1.data));
+  assert(((void) "Interns different strings into different buffers", i1.data != i3.data));
+  assert(((void) "Returns interned string as is", i4.data == i1.data));
+  assert(((void) "Interns empty string", i5.len == 0 && i5.data != NULL));
+  assert(((void) "Copies interned string by pointer", c1.data == i1.data));
+  assert(((void) "Interned strings are equal", d4_str_eq(i1, i2) && d4_str_eq(i1, s2)));
+  assert(((void) "Interned strings are not equal", !d4_str_eq(i1, i3)));
+  assert(((void) "Hashes interned strings equally", d4_str_hash(i1) == d4_str_hash(s1) && d4_str_hash(i3) == d4_str_hash(s3)));
+  assert(((void) "Counts hits", stats2.hits - stats1.hits == 1));
+  assert(((void) "Counts misses", stats2.misses - stats1.misses == 3));
+  assert(((void) "Counts length", stats2.len - stats1.len == 3));
 
-static void test_string_toF32 (void) {
-  // todo
-}
+  d4_str_free(c1);
+  d4_str_free(i1);
+  d4_str_free(s1);
+  d4_str_free(s2);
+  d4_str_free(s3);
 
-static void test_string_toF64 (void) {
-  // todo
+  assert(((void) "Keeps interned string after free", wcscmp(i2.data, L"string") == 0));
 }
 
-static void test_string_toIsize (void) {
-  // todo
-}
+static void test_string_le (void) {
+  d4_str_t s1 = d4_str_alloc(L"abc");
+  d4_str_t s2 = d4_str_alloc(L"abd");
+  d4_str_t s3 = d4_str_alloc(L"ab");
 
-static void test_string_toI8 (void) {
-  // todo
-}
+  assert(((void) "Checks equal", d4_str_le(s1, s1)));
+  assert(((void) "Checks less", d4_str_le(s1, s2)));
+  assert(((void) "Checks greater", !d4_str_le(s2, s1)));
+  assert(((void) "Checks longer", !d4_str_le(s1, s3)));
+  assert(((void) "Checks shorter", d4_str_le(s3, s1)));
+  assert(((void) "Checks empty", d4_str_le(d4_str_empty_val, s3) && d4_str_le(d4_str_empty_val, d4_str_empty_val)));
 
-static void test_string_toI16 (void) {
-  // todo
+  d4_str_free(s1);
+  d4_str_free(s2);
+  d4_str_free(s3);
 }
 
-static void test_string_toI32 (void) {
-  // todo
+static void test_string_lines (void) {
+  d4_str_t s1 = d4_str_alloc(L"a\r\nb\n\rc\n");
+  d4_arr_str_t a1 = d4_str_lines(s1, 0, false);
+  d4_arr_str_t a2 = d4_str_lines(s1, 1, true);
+  d4_arr_str_t a3 = d4_str_lines(d4_str_empty_val, 0, false);
+
+  assert(((void) "Splits lines", a1.len == 4));
+  assert(((void) "Splits CRLF as one line break", wcscmp(a1.data[0].data, L"a") == 0));
+  assert(((void) "Splits LF and CR separately", a1.data[1].len == 1 && a1.data[2].len == 0));
+  assert(((void) "Doesn't add trailing empty line", wcscmp(a1.data[3].data, L"c") == 0));
+  assert(((void) "Keeps line breaks", a2.len == 4 && wcscmp(a2.data[0].data, L"a\r\n") == 0));
+  assert(((void) "Keeps last line break", wcscmp(a2.data[3].data, L"c\n") == 0));
+  assert(((void) "Splits empty", a3.len == 0));
+
+  d4_arr_str_free(a1);
+  d4_arr_str_free(a2);
+  d4_arr_str_free(a3);
+  d4_str_free(s1);
 }
 
-static void test_string_toI64 (void) {
-  // todo
-}
+static void test_string_lines_iter (void) {
+  d4_str_t s1 = d4_str_alloc(L"a\nb");
+  d4_str_lines_iter_t it1 = d4_str_lines_iter(s1, 0, true);
+  d4_str_lines_iter_t it2 = d4_str_lines_iter(s1, 1, true);
 
-static void test_string_toUsize (void) {
-  // todo
-}
+  assert(((void) "Starts at beginning", it1.pos == 0 && it1.str.data == s1.data));
+  assert(((void) "Ignores keepLineBreaks when not specified", !it1.keep_line_breaks));
+  assert(((void) "Keeps line breaks when specified", it2.keep_line_breaks));
 
-static void test_string_toU8 (void) {
-  // todo
+  d4_str_free(s1);
 }
 
-static void test_string_toU16 (void) {
-  // todo
-}
+static void test_string_lines_iter_next (void) {
+  d4_str_t s1 = d4_str_alloc(L"ab\r\n\ncd");
+  d4_str_lines_iter_t it1 = d4_str_lines_iter(s1, 0, false);
+  d4_str_lines_iter_t it2 = d4_str_lines_iter(s1, 1, true);
+  d4_str_lines_iter_t it3 = d4_str_lines_iter(d4_str_empty_val, 0, false);
+  d4_str_view_t v1;
 
-static void test_string_toU32 (void) {
-  // todo
-}
+  assert(((void) "Yields first line", d4_str_lines_iter_next(&it1, &v1) && v1.data == s1.data && v1.len == 2));
+  assert(((void) "Yields empty line", d4_str_lines_iter_next(&it1, &v1) && v1.len == 0));
+  assert(((void) "Yields last line", d4_str_lines_iter_next(&it1, &v1) && v1.data == &s1.data[5] && v1.len == 2));
+  assert(((void) "Stops after last line", !d4_str_lines_iter_next(&it1, &v1)));
+  assert(((void) "Yields line with line break", d4_str_lines_iter_next(&it2, &v1) && v1.len == 4));
+  assert(((void) "Yields nothing for empty", !d4_str_lines_iter_next(&it3, &v1)));
 
-static void test_string_toU64 (void) {
-  // todo
+  d4_str_free(s1);
 }
 
-static void test_string_trim (void) {
-  // todo
+static void test_string_lower (void) {
+  d4_str_t s1 = d4_str_empty_val;
+  d4_str_t s2 = d4_str_alloc(L"Hello World");
+  d4_str_t s3 = d4_str_alloc(L"\u00C9COLE \u0434\u043E\u043C");
+  d4_str_t s4 = d4_str_alloc(L"THE QUICK BROWN FOX JUMPS OVER \u00C9COLE \u0414\u041E\u041C AND \u03A9MEGA @[`{");
+
+  d4_str_t l1 = d4_str_lower(s1);
+  d4_str_t l2 = d4_str_lower(s2);
+  d4_str_t l3 = d4_str_lower(s3);
+  d4_str_t l4 = d4_str_lower(s4);
+
+  assert(((void) "Lowers empty", d4_str_eq(l1, s1)));
+  assert(((void) "Lowers ASCII", wcscmp(l2.data, L"hello world") == 0));
+  assert(((void) "Lowers non-ASCII", wcscmp(l3.data, L"\u00E9cole \u0434\u043E\u043C") == 0));
+  assert(((void) "Lowers mixed", wcscmp(l4.data, L"the quick brown fox jumps over \u00E9cole \u0434\u043E\u043C and \u03C9mega @[`{") == 0));
+
+  d4_str_free(l1);
+  d4_str_free(l2);
+  d4_str_free(l3);
+  d4_str_free(l4);
+  d4_str_free(s1);
+  d4_str_free(s2);
+  d4_str_free(s3);
+  d4_str_free(s4);
 }
 
-static void test_string_trimEnd (void) {
+static void test_string_lowerFirst (void) {
   // todo
 }
 
-static void test_string_trimStart (void) {
+static void test_string_lowerInPlace (void) {
+  d4_str_t s1 = d4_str_alloc(L"Hello \u00C9COLE");
+  d4_str_t s2 = d4_str_alloc(L"HELLO");
+  d4_str_t s3 = d4_str_copy(s2);
+  wchar_t *d = s1.data;
+
+  s1 = d4_str_lowerInPlace(s1);
+  s2 = d4_str_lowerInPlace(s2);
+
+  assert(((void) "Lowers in place", s1.data == d && wcscmp(s1.data, L"hello \u00E9cole") == 0));
+  assert(((void) "Lowers shared", wcscmp(s2.data, L"hello") == 0 && wcscmp(s3.data, L"HELLO") == 0));
+  assert(((void) "Compares after lowering", d4_str_eq(s2, (d4_str_view_t) {L"hello", 5, true, false})));
+
+  d4_str_free(s1);
+  d4_str_free(s2);
+  d4_str_free(s3);
+}
+
+static void test_string_lt (void) {
+  d4_str_t s1 = d4_str_alloc(L"abc");
+  d4_str_t s2 = d4_str_alloc(L"abd");
+  d4_str_t s3 = d4_str_alloc(L"ab");
+
+  assert(((void) "Checks equal", !d4_str_lt(s1, s1)));
+  assert(((void) "Checks less", d4_str_lt(s1, s2)));
+  assert(((void) "Checks greater", !d4_str_lt(s2, s1)));
+  assert(((void) "Checks longer", !d4_str_lt(s1, s3)));
+  assert(((void) "Checks shorter", d4_str_lt(s3, s1)));
+  assert(((void) "Checks empty", d4_str_lt(d4_str_empty_val, s3) && !d4_str_lt(s3, d4_str_empty_val)));
+
+  d4_str_free(s1);
+  d4_str_free(s2);
+  d4_str_free(s3);
+}
+
+static void test_string_matcher_alloc (void) {
+  d4_str_t s1 = d4_str_alloc(L"he");
+  d4_str_t s2 = d4_str_alloc(L"she");
+  d4_arr_str_t a1 = d4_arr_str_alloc(2, s1, s2);
+  d4_str_matcher_t m1 = d4_str_matcher_alloc(a1);
+  d4_str_matcher_t m2 = d4_str_matcher_alloc(d4_arr_str_alloc(0));
+
+  assert(((void) "Builds automaton", m1.ctx != NULL && m1.len == 2));
+  assert(((void) "Builds empty automaton", m2.ctx != NULL && m2.len == 0));
+
+  d4_str_matcher_free(m1);
+  d4_str_matcher_free(m2);
+  d4_arr_str_free(a1);
+  d4_str_free(s1);
+  d4_str_free(s2);
+}
+
+static void test_string_matcher_findAll (void) {
+  d4_str_t s1 = d4_str_alloc(L"he");
+  d4_str_t s2 = d4_str_alloc(L"she");
+  d4_str_t s3 = d4_str_alloc(L"hers");
+  d4_str_t s4 = d4_str_alloc(L"ushers and heroes");
+  d4_arr_str_t a1 = d4_arr_str_alloc(3, s1, s2, s3);
+  d4_str_matcher_t m1 = d4_str_matcher_alloc(a1);
+  d4_str_match_t r1[3];
+
+  assert(((void) "Finds matches", d4_str_matcher_findAll(m1, s4, r1, 3) == 2));
+  assert(((void) "Finds leftmost match", r1[0].pattern == 1 && r1[0].start == 1 && r1[0].len == 3));
+  assert(((void) "Finds longest match", r1[1].pattern == 0 && r1[1].start == 11 && r1[1].len == 2));
+  assert(((void) "Counts matches", d4_str_matcher_findAll(m1, s3, NULL, 0) == 1));
+  assert(((void) "Finds nothing", d4_str_matcher_findAll(m1, d4_str_empty_val, NULL, 0) == 0));
+
+  d4_str_matcher_free(m1);
+  d4_arr_str_free(a1);
+  d4_str_free(s1);
+  d4_str_free(s2);
+  d4_str_free(s3);
+  d4_str_free(s4);
+}
+
+static void test_string_matcher_free (void) {
+  d4_str_t s1 = d4_str_alloc(L"pattern");
+  d4_arr_str_t a1 = d4_arr_str_alloc(1, s1);
+  d4_str_matcher_t m1 = d4_str_matcher_alloc(a1);
+
+  d4_arr_str_free(a1);
+  d4_str_free(s1);
+  d4_str_matcher_free(m1);
+}
+
+static void test_string_matcher_replace (void) {
+  d4_str_t s1 = d4_str_alloc(L"<");
+  d4_str_t s2 = d4_str_alloc(L">");
+  d4_str_t s3 = d4_str_alloc(L"&");
+  d4_str_t s4 = d4_str_alloc(L"&lt;");
+  d4_str_t s5 = d4_str_alloc(L"&gt;");
+  d4_str_t s6 = d4_str_alloc(L"<a href=\"?a=1&b=2\">");
+  d4_arr_str_t a1 = d4_arr_str_alloc(3, s1, s2, s3);
+  d4_arr_str_t a2 = d4_arr_str_alloc(2, s4, s5);
+  d4_str_matcher_t m1 = d4_str_matcher_alloc(a1);
+  d4_str_t r1 = d4_str_matcher_replace(m1, s6, a2);
+  d4_str_t r2 = d4_str_matcher_replace(m1, s4, a2);
+
+  assert(((void) "Replaces all patterns", wcscmp(r1.data, L"&lt;a href=\"?a=1b=2\"&gt;") == 0));
+  assert(((void) "Removes patterns without replacement", wcscmp(r2.data, L"lt;") == 0));
+
+  d4_str_free(r1);
+  d4_str_free(r2);
+  d4_str_matcher_free(m1);
+  d4_arr_str_free(a1);
+  d4_arr_str_free(a2);
+  d4_str_free(s1);
+  d4_str_free(s2);
+  d4_str_free(s3);
+  d4_str_free(s4);
+  d4_str_free(s5);
+  d4_str_free(s6);
+}
+
+static void test_string_not (void) {
   // todo
 }
 
-static void test_string_upper (void) {
+static void test_string_quoted_escape (void) {
+  d4_str_t s1 = d4_str_alloc(L"key");
+  d4_str_t s2 = d4_str_alloc(L"long text without escapes, \"quoted\"\tand\r\nbroken");
+  d4_str_t q1 = d4_str_quoted_escape(d4_str_empty_val);
+  d4_str_t q2 = d4_str_quoted_escape(s1);
+  d4_str_t q3 = d4_str_quoted_escape(s2);
+
+  assert(((void) "Quotes empty", wcscmp(q1.data, L"\"\"") == 0 && q1.len == 2));
+  assert(((void) "Quotes without escapes", wcscmp(q2.data, L"\"key\"") == 0));
+  assert(((void) "Quotes and escapes", wcscmp(q3.data, L"\"long text without escapes, \\\"quoted\\\"\\tand\\r\\nbroken\"") == 0));
+
+  d4_str_free(q1);
+  d4_str_free(q2);
+  d4_str_free(q3);
+  d4_str_free(s1);
+  d4_str_free(s2);
+}
+
+static void test_string_realloc (void) {
+  d4_str_t s1 = d4_str_alloc(L"string");
+  d4_str_t s2 = d4_str_alloc(L"a");
+  d4_str_t s3 = d4_str_alloc(L"other string");
+
+  s1 = d4_str_realloc(s1, s2);
+  assert(((void) "Reallocates to single character", d4_str_eq(s1, s2)));
+
+  s1 = d4_str_realloc(s1, s3);
+  assert(((void) "Reallocates from single character", d4_str_eq(s1, s3)));
+
+  s1 = d4_str_realloc(s1, s1);
+  assert(((void) "Reallocates to itself", d4_str_eq(s1, s3)));
+
+  d4_str_free(s1);
+  d4_str_free(s2);
+  d4_str_free(s3);
+}
+
+static void test_string_replace (void) {
+  d4_str_t s1 = d4_str_alloc(L"a-b-c");
+  d4_str_t s2 = d4_str_alloc(L"-");
+  d4_str_t s3 = d4_str_alloc(L"+=");
+  d4_str_t r1 = d4_str_replace(s1, s2, s3, 0, 0);
+  d4_str_t r2 = d4_str_replace(s1, s2, d4_str_empty_val, 1, 1);
+  d4_str_t r3 = d4_str_replace(s1, d4_str_empty_val, s2, 1, 2);
+  d4_str_t r4 = d4_str_replace(s1, s3, s2, 0, 0);
+
+  assert(((void) "Replaces all occurrences", wcscmp(r1.data, L"a+=b+=c") == 0));
+  assert(((void) "Replaces with empty string", wcscmp(r2.data, L"ab-c") == 0));
+  assert(((void) "Replaces empty string", wcscmp(r3.data, L"-a--b-c") == 0));
+  assert(((void) "Replaces nothing", d4_str_eq(r4, s1)));
+
+  d4_str_free(r1);
+  d4_str_free(r2);
+  d4_str_free(r3);
+  d4_str_free(r4);
+  d4_str_free(s1);
+  d4_str_free(s2);
+  d4_str_free(s3);
+}
+
+static void test_string_replaceInto (void) {
+  d4_str_t s1 = d4_str_alloc(L"a--b--c--d");
+  d4_str_t s2 = d4_str_alloc(L"--");
+  d4_str_t s3 = d4_str_alloc(L"-");
+  d4_str_t s4 = d4_str_alloc(L"<->");
+  d4_str_t s5 = d4_str_copy(s1);
+  d4_str_t s6 = d4_str_alloc(L"----");
+  wchar_t *d = s1.data;
+
+  d4_str_free(s5);
+  s1 = d4_str_replaceInto(s1, s2, s3, 1, 2);
+  assert(((void) "Replaces in place", s1.data == d && wcscmp(s1.data, L"a-b-c--d") == 0 && s1.len == 8));
+
+  s1 = d4_str_replaceInto(s1, s2, s4, 0, 0);
+  assert(((void) "Replaces with longer", wcscmp(s1.data, L"a-b-c<->d") == 0));
+
+  s1 = d4_str_replaceInto(s1, s4, d4_str_empty_val, 0, 0);
+  assert(((void) "Replaces with empty", wcscmp(s1.data, L"a-b-cd") == 0));
+
+  s1 = d4_str_replaceInto(s1, s4, s3, 0, 0);
+  assert(((void) "Replaces nothing", wcscmp(s1.data, L"a-b-cd") == 0));
+
+  s6 = d4_str_replaceInto(s6, s2, d4_str_empty_val, 0, 0);
+  assert(((void) "Replaces everything", s6.len == 0));
+
+  d4_str_free(s1);
+  d4_str_free(s2);
+  d4_str_free(s3);
+  d4_str_free(s4);
+  d4_str_free(s6);
+}
+
+static void test_string_rope_alloc (void) {
+  d4_str_t s1 = d4_str_alloc(L"Hello");
+  d4_str_rope_t r1 = d4_str_rope_alloc(d4_str_empty_val);
+  d4_str_rope_t r2 = d4_str_rope_alloc(s1);
+
+  assert(((void) "Allocates empty", r1.ctx == NULL && r1.len == 0));
+  assert(((void) "Allocates from string", r2.ctx != NULL && r2.len == 5));
+
+  d4_str_rope_free(r1);
+  d4_str_rope_free(r2);
+  d4_str_free(s1);
+}
+
+static void test_string_rope_append (void) {
+  d4_str_t s1 = d4_str_alloc(L"Hello");
+  d4_str_t s2 = d4_str_alloc(L", World");
+  d4_str_rope_t r1 = d4_str_rope_alloc(s1);
+  d4_str_rope_t r2 = d4_str_rope_append(r1, s2);
+  d4_str_rope_t r3 = d4_str_rope_alloc(d4_str_empty_val);
+  d4_str_t t1 = d4_str_rope_str(r1);
+  d4_str_t t2 = d4_str_rope_str(r2);
+  d4_str_t t3;
+
+  for (int32_t i = 0; i < 1000; i++) {
+    d4_str_t s3 = d4_str_alloc(L"%d,", i % 10);
+    d4_str_rope_t r4 = d4_str_rope_append(r3, s3);
+
+    d4_str_rope_free(r3);
+    d4_str_free(s3);
+    r3 = r4;
+  }
+
+  t3 = d4_str_rope_str(r3);
+
+  assert(((void) "Keeps original", wcscmp(t1.data, L"Hello") == 0));
+  assert(((void) "Appends", wcscmp(t2.data, L"Hello, World") == 0 && r2.len == 12));
+  assert(((void) "Appends many", r3.len == 2000 && t3.len == 2000 && wcsncmp(&t3.data[1990], L"5,6,7,8,9,", 10) == 0));
+
+  d4_str_free(t1);
+  d4_str_free(t2);
+  d4_str_free(t3);
+  d4_str_rope_free(r1);
+  d4_str_rope_free(r2);
+  d4_str_rope_free(r3);
+  d4_str_free(s1);
+  d4_str_free(s2);
+}
+
+static void test_string_rope_at (void) {
+  d4_str_t s1 = d4_str_alloc(L"0123456789");
+  d4_str_t s2 = d4_str_alloc(L"abcdefghij");
+  d4_str_rope_t r1 = d4_str_rope_alloc(s1);
+  d4_str_rope_t r2 = d4_str_rope_alloc(s2);
+  d4_str_rope_t r3 = d4_str_rope_concat(r1, r2);
+
+  ASSERT_THROW_WITH_MESSAGE(ROPE_AT1, {
+    d4_str_rope_at(&d4_err_state, 0, 0, r3, 20);
+  }, L"index 20 out of rope bounds");
+
+  ASSERT_THROW_WITH_MESSAGE(ROPE_AT2, {
+    d4_str_rope_at(&d4_err_state, 0, 0, r3, -21);
+  }, L"index -21 out of rope bounds");
+
+  ASSERT_NO_THROW(ROPE_AT3, {
+    assert(((void) "Finds in left chunk", d4_str_rope_at(&d4_err_state, 0, 0, r3, 9) == L'9'));
+    assert(((void) "Finds in right chunk", d4_str_rope_at(&d4_err_state, 0, 0, r3, 10) == L'a'));
+    assert(((void) "Finds from the end", d4_str_rope_at(&d4_err_state, 0, 0, r3, -1) == L'j'));
+  });
+
+  d4_str_rope_free(r1);
+  d4_str_rope_free(r2);
+  d4_str_rope_free(r3);
+  d4_str_free(s1);
+  d4_str_free(s2);
+}
+
+static void test_string_rope_concat (void) {
+  d4_str_t s1 = d4_str_alloc(L"Hello, ");
+  d4_str_t s2 = d4_str_alloc(L"World");
+  d4_str_rope_t r1 = d4_str_rope_alloc(s1);
+  d4_str_rope_t r2 = d4_str_rope_alloc(s2);
+  d4_str_rope_t r3 = d4_str_rope_alloc(d4_str_empty_val);
+  d4_str_rope_t r4 = d4_str_rope_concat(r1, r2);
+  d4_str_rope_t r5 = d4_str_rope_concat(r3, r1);
+  d4_str_rope_t r6 = d4_str_rope_concat(r4, r4);
+  d4_str_t t4 = d4_str_rope_str(r4);
+  d4_str_t t5 = d4_str_rope_str(r5);
+  d4_str_t t6 = d4_str_rope_str(r6);
+
+  assert(((void) "Concatenates", wcscmp(t4.data, L"Hello, World") == 0));
+  assert(((void) "Concatenates with empty", wcscmp(t5.data, L"Hello, ") == 0));
+  assert(((void) "Concatenates with itself", wcscmp(t6.data, L"Hello, WorldHello, World") == 0 && r6.len == 24));
+
+  d4_str_free(t4);
+  d4_str_free(t5);
+  d4_str_free(t6);
+  d4_str_rope_free(r1);
+  d4_str_rope_free(r2);
+  d4_str_rope_free(r3);
+  d4_str_rope_free(r4);
+  d4_str_rope_free(r5);
+  d4_str_rope_free(r6);
+  d4_str_free(s1);
+  d4_str_free(s2);
+}
+
+static void test_string_rope_copy (void) {
+  d4_str_t s1 = d4_str_alloc(L"Hello");
+  d4_str_rope_t r1 = d4_str_rope_alloc(s1);
+  d4_str_rope_t r2 = d4_str_rope_copy(r1);
+
+  assert(((void) "Shares tree", r1.ctx == r2.ctx && r1.len == r2.len));
+  d4_str_rope_free(r1);
+  assert(((void) "Outlives original", d4_str_rope_at(&d4_err_state, 0, 0, r2, 0) == L'H'));
+
+  d4_str_rope_free(r2);
+  d4_str_free(s1);
+}
+
+static void test_string_rope_free (void) {
+  d4_str_t s1 = d4_str_alloc(L"Hello");
+  d4_str_rope_t r1 = d4_str_rope_alloc(s1);
+
+  d4_str_rope_free(d4_str_rope_alloc(d4_str_empty_val));
+  d4_str_rope_free(d4_str_rope_concat(r1, r1));
+  d4_str_rope_free(r1);
+  d4_str_free(s1);
+}
+
+static void test_string_rope_insert (void) {
+  d4_str_t s1 = d4_str_alloc(L"Hello World");
+  d4_str_t s2 = d4_str_alloc(L",");
+  d4_str_t s3 = d4_str_alloc(L"!");
+  d4_str_rope_t r1 = d4_str_rope_alloc(s1);
+  d4_str_rope_t r2 = d4_str_rope_alloc(d4_str_empty_val);
+
+  ASSERT_THROW_WITH_MESSAGE(ROPE_INSERT1, {
+    d4_str_rope_insert(&d4_err_state, 0, 0, r1, 12, s2);
+  }, L"index 12 out of rope bounds");
+
+  ASSERT_THROW_WITH_MESSAGE(ROPE_INSERT2, {
+    d4_str_rope_insert(&d4_err_state, 0, 0, r1, -12, s2);
+  }, L"index -12 out of rope bounds");
+
+  ASSERT_NO_THROW(ROPE_INSERT3, {
+    d4_str_rope_t r3 = d4_str_rope_insert(&d4_err_state, 0, 0, r1, 5, s2);
+    d4_str_rope_t r4 = d4_str_rope_insert(&d4_err_state, 0, 0, r3, -6, s3);
+    d4_str_rope_t r5 = d4_str_rope_insert(&d4_err_state, 0, 0, r2, 0, s3);
+    d4_str_t t3 = d4_str_rope_str(r3);
+    d4_str_t t4 = d4_str_rope_str(r4);
+    d4_str_t t5 = d4_str_rope_str(r5);
+
+    assert(((void) "Inserts in the middle", wcscmp(t3.data, L"Hello, World") == 0));
+    assert(((void) "Inserts from the end", wcscmp(t4.data, L"Hello,! World") == 0 && r4.len == 13));
+    assert(((void) "Inserts into empty", wcscmp(t5.data, L"!") == 0));
+
+    d4_str_free(t3);
+    d4_str_free(t4);
+    d4_str_free(t5);
+    d4_str_rope_free(r3);
+    d4_str_rope_free(r4);
+    d4_str_rope_free(r5);
+  });
+
+  d4_str_rope_free(r1);
+  d4_str_rope_free(r2);
+  d4_str_free(s1);
+  d4_str_free(s2);
+  d4_str_free(s3);
+}
+
+static void test_string_rope_iter (void) {
+  d4_str_t s1 = d4_str_alloc(L"Hello");
+  d4_str_rope_t r1 = d4_str_rope_alloc(s1);
+  d4_str_rope_iter_t it1 = d4_str_rope_iter(r1);
+
+  assert(((void) "Starts at beginning", it1.pos == 0 && it1.rope.ctx == r1.ctx));
+
+  d4_str_rope_free(r1);
+  d4_str_free(s1);
+}
+
+static void test_string_rope_iter_next (void) {
+  d4_str_t s1 = d4_str_alloc(L"%0*d", 200, 1);
+  d4_str_t s2 = d4_str_alloc(L"%0*d", 300, 2);
+  d4_str_rope_t r1 = d4_str_rope_alloc(s1);
+  d4_str_rope_t r2 = d4_str_rope_alloc(s2);
+  d4_str_rope_t r3 = d4_str_rope_concat(r1, r2);
+  d4_str_rope_t r4 = d4_str_rope_alloc(d4_str_empty_val);
+  d4_str_rope_iter_t it1 = d4_str_rope_iter(r3);
+  d4_str_rope_iter_t it2 = d4_str_rope_iter(r4);
+  d4_str_view_t v1;
+
+  assert(((void) "Yields first chunk", d4_str_rope_iter_next(&it1, &v1) && v1.data == s1.data && v1.len == 200));
+  assert(((void) "Yields second chunk", d4_str_rope_iter_next(&it1, &v1) && v1.data == s2.data && v1.len == 300));
+  assert(((void) "Stops after last chunk", !d4_str_rope_iter_next(&it1, &v1)));
+  assert(((void) "Yields nothing for empty", !d4_str_rope_iter_next(&it2, &v1)));
+
+  d4_str_rope_free(r1);
+  d4_str_rope_free(r2);
+  d4_str_rope_free(r3);
+  d4_str_rope_free(r4);
+  d4_str_free(s1);
+  d4_str_free(s2);
+}
+
+static void test_string_rope_slice (void) {
+  d4_str_t s1 = d4_str_alloc(L"Hello, ");
+  d4_str_t s2 = d4_str_alloc(L"World");
+  d4_str_rope_t r1 = d4_str_rope_alloc(s1);
+  d4_str_rope_t r2 = d4_str_rope_alloc(s2);
+  d4_str_rope_t r3 = d4_str_rope_concat(r1, r2);
+  d4_str_rope_t r4 = d4_str_rope_slice(r3, 1, 5, 1, 9);
+  d4_str_rope_t r5 = d4_str_rope_slice(r3, 1, -5, 0, 0);
+  d4_str_rope_t r6 = d4_str_rope_slice(r3, 1, 8, 1, 2);
+  d4_str_rope_t r7 = d4_str_rope_slice(r3, 0, 0, 0, 0);
+  d4_str_t t4 = d4_str_rope_str(r4);
+  d4_str_t t5 = d4_str_rope_str(r5);
+  d4_str_t t7 = d4_str_rope_str(r7);
+
+  assert(((void) "Slices across chunks", wcscmp(t4.data, L", Wo") == 0 && r4.len == 4));
+  assert(((void) "Slices from the end", wcscmp(t5.data, L"World") == 0));
+  assert(((void) "Slices empty", r6.ctx == NULL && r6.len == 0));
+  assert(((void) "Slices whole", wcscmp(t7.data, L"Hello, World") == 0));
+
+  d4_str_free(t4);
+  d4_str_free(t5);
+  d4_str_free(t7);
+  d4_str_rope_free(r1);
+  d4_str_rope_free(r2);
+  d4_str_rope_free(r3);
+  d4_str_rope_free(r4);
+  d4_str_rope_free(r5);
+  d4_str_rope_free(r6);
+  d4_str_rope_free(r7);
+  d4_str_free(s1);
+  d4_str_free(s2);
+}
+
+static void test_string_rope_str (void) {
+  d4_str_t s1 = d4_str_alloc(L"%0*d", 200, 1);
+  d4_str_rope_t r1 = d4_str_rope_alloc(s1);
+  d4_str_rope_t r2 = d4_str_rope_alloc(d4_str_empty_val);
+  d4_str_rope_t r3 = d4_str_rope_slice(r1, 1, 1, 0, 0);
+  d4_str_t t1 = d4_str_rope_str(r1);
+  d4_str_t t2 = d4_str_rope_str(r2);
+  d4_str_t t3 = d4_str_rope_str(r3);
+
+  assert(((void) "Flattens whole string without copying", t1.data == s1.data));
+  assert(((void) "Flattens empty", t2.len == 0));
+  assert(((void) "Flattens slice", t3.len == 199 && t3.data != s1.data && t3.data[198] == L'1' && t3.data[199] == L'\0'));
+
+  d4_str_free(t1);
+  d4_str_free(t2);
+  d4_str_free(t3);
+  d4_str_rope_free(r1);
+  d4_str_rope_free(r2);
+  d4_str_rope_free(r3);
+  d4_str_free(s1);
+}
+
+static void test_string_searcher_alloc (void) {
+  d4_str_t s1 = d4_str_alloc(L"needle");
+  d4_str_t s2 = d4_str_alloc(L"a needle that is long enough to use shift table");
+  d4_str_searcher_t r1 = d4_str_searcher_alloc(s1);
+  d4_str_searcher_t r2 = d4_str_searcher_alloc(s2);
+
+  assert(((void) "Compiles short needle", d4_str_eq(r1.needle, s1) && r1.shift == NULL));
+  assert(((void) "Compiles long needle", d4_str_eq(r2.needle, s2) && r2.shift != NULL));
+
+  d4_str_searcher_free(r1);
+  d4_str_searcher_free(r2);
+  d4_str_free(s1);
+  d4_str_free(s2);
+}
+
+static void test_string_searcher_count (void) {
+  d4_str_t s1 = d4_str_alloc(L"aaaa");
+  d4_str_t s2 = d4_str_alloc(L"aa");
+  d4_str_searcher_t r1 = d4_str_searcher_alloc(s2);
+  d4_str_searcher_t r2 = d4_str_searcher_alloc(d4_str_empty_val);
+
+  assert(((void) "Counts non-overlapping occurrences", d4_str_searcher_count(r1, s1) == 2));
+  assert(((void) "Counts nothing", d4_str_searcher_count(r1, s2) == 1));
+  assert(((void) "Counts empty needle", d4_str_searcher_count(r2, s1) == 5));
+
+  d4_str_searcher_free(r1);
+  d4_str_searcher_free(r2);
+  d4_str_free(s1);
+  d4_str_free(s2);
+}
+
+static void test_string_searcher_find (void) {
+  d4_str_t s1 = d4_str_alloc(L"the long needle is here: 0123456789abcdefghijklmnopqrstuvwxyz!");
+  d4_str_t s2 = d4_str_alloc(L"0123456789abcdefghijklmnopqrstuvwxyz");
+  d4_str_t s3 = d4_str_alloc(L"here");
+  d4_str_t s4 = d4_str_alloc(L"there");
+  d4_str_searcher_t r1 = d4_str_searcher_alloc(s2);
+  d4_str_searcher_t r2 = d4_str_searcher_alloc(s3);
+  d4_str_searcher_t r3 = d4_str_searcher_alloc(s4);
+
+  assert(((void) "Finds long needle", d4_str_searcher_find(r1, s1) == 25));
+  assert(((void) "Finds short needle", d4_str_searcher_find(r2, s1) == 19));
+  assert(((void) "Doesn't find needle", d4_str_searcher_find(r3, s1) == -1));
+  assert(((void) "Doesn't find long needle in short string", d4_str_searcher_find(r1, s3) == -1));
+
+  d4_str_searcher_free(r1);
+  d4_str_searcher_free(r2);
+  d4_str_searcher_free(r3);
+  d4_str_free(s1);
+  d4_str_free(s2);
+  d4_str_free(s3);
+  d4_str_free(s4);
+}
+
+static void test_string_searcher_findAll (void) {
+  d4_str_t s1 = d4_str_alloc(L"a,b,,c");
+  d4_str_t s2 = d4_str_alloc(L",");
+  d4_str_searcher_t r1 = d4_str_searcher_alloc(s2);
+  int32_t p1[2];
+  int32_t p2[4];
+
+  assert(((void) "Finds more than capacity", d4_str_searcher_findAll(r1, s1, p1, 2) == 3 && p1[0] == 1 && p1[1] == 3));
+  assert(((void) "Finds all", d4_str_searcher_findAll(r1, s1, p2, 4) == 3 && p2[2] == 4));
+  assert(((void) "Finds without positions", d4_str_searcher_findAll(r1, s2, NULL, 0) == 1));
+
+  d4_str_searcher_free(r1);
+  d4_str_free(s1);
+  d4_str_free(s2);
+}
+
+static void test_string_searcher_free (void) {
+  d4_str_t s1 = d4_str_alloc(L"needle");
+  d4_str_searcher_t r1 = d4_str_searcher_alloc(s1);
+
+  d4_str_free(s1);
+  d4_str_searcher_free(r1);
+}
+
+static void test_string_searcher_replace (void) {
+  d4_str_t s1 = d4_str_alloc(L"{{name}} and {{name}} and {{name}}");
+  d4_str_t s2 = d4_str_alloc(L"{{name}}");
+  d4_str_t s3 = d4_str_alloc(L"Aaron");
+  d4_str_searcher_t r1 = d4_str_searcher_alloc(s2);
+  d4_str_t t1 = d4_str_searcher_replace(r1, s1, s3, 0, 0);
+  d4_str_t t2 = d4_str_searcher_replace(r1, s1, s3, 1, 2);
+
+  assert(((void) "Replaces all occurrences", wcscmp(t1.data, L"Aaron and Aaron and Aaron") == 0));
+  assert(((void) "Replaces some occurrences", wcscmp(t2.data, L"Aaron and Aaron and {{name}}") == 0));
+
+  d4_str_free(t1);
+  d4_str_free(t2);
+  d4_str_searcher_free(r1);
+  d4_str_free(s1);
+  d4_str_free(s2);
+  d4_str_free(s3);
+}
+
+static void test_string_slice (void) {
   // todo
 }
 
+static void test_string_sliceView (void) {
+  d4_str_t s1 = d4_str_alloc(L"Hello World");
+  d4_str_view_t v1 = d4_str_sliceView(s1, 1, 6, 0, 0);
+  d4_str_view_t v2 = d4_str_sliceView(s1, 1, -5, 1, -2);
+  d4_str_view_t v3 = d4_str_sliceView(s1, 1, 5, 1, 2);
+  d4_str_t c1 = d4_str_copy(v1);
+
+  assert(((void) "Slices without copying", v1.data == &s1.data[6] && v1.len == 5 && v1.is_static));
+  assert(((void) "Slices with negative positions", v2.data == &s1.data[6] && v2.len == 3));
+  assert(((void) "Slices empty", d4_str_eq(v3, d4_str_empty_val)));
+  assert(((void) "Copies view", c1.data != v1.data && wcscmp(c1.data, L"World") == 0));
+
+  d4_str_free(v1);
+  d4_str_free(c1);
+  d4_str_free(s1);
+}
+
+static void test_string_split (void) {
+  d4_str_t s1 = d4_str_alloc(L"a,,b");
+  d4_str_t s2 = d4_str_alloc(L",");
+  d4_arr_str_t a1 = d4_str_split(s1, 1, s2);
+
+  assert(((void) "Splits into parts", a1.len == 3));
+  assert(((void) "Splits part 1", wcscmp(a1.data[0].data, L"a") == 0));
+  assert(((void) "Splits part 2", a1.data[1].len == 0));
+  assert(((void) "Splits part 3", wcscmp(a1.data[2].data, L"b") == 0));
+
+  d4_arr_str_free(a1);
+  d4_str_free(s1);
+  d4_str_free(s2);
+}
+
+static void test_string_splitView (void) {
+  d4_str_t s1 = d4_str_alloc(L"key::value::");
+  d4_str_t s2 = d4_str_alloc(L"::");
+  d4_str_t s3 = d4_str_alloc(L"key");
+  d4_str_t s4 = d4_str_alloc(L"value");
+  d4_arr_str_t a1 = d4_str_splitView(s1, 1, s2);
+
+  assert(((void) "Splits into views", a1.len == 3));
+  assert(((void) "Splits view 1", a1.data[0].data == s1.data && d4_str_eq(a1.data[0], s3)));
+  assert(((void) "Splits view 2", a1.data[1].data == &s1.data[5] && d4_str_eq(a1.data[1], s4)));
+  assert(((void) "Splits view 3", a1.data[2].len == 0));
+
+  d4_arr_str_free(a1);
+  d4_str_free(s1);
+  d4_str_free(s2);
+  d4_str_free(s3);
+  d4_str_free(s4);
+}
+
+static void test_string_split_iter (void) {
+  d4_str_t s1 = d4_str_alloc(L"a,b");
+  d4_str_t s2 = d4_str_alloc(L",");
+  d4_str_split_iter_t it1 = d4_str_split_iter(s1, 1, s2, 0, 0);
+  d4_str_split_iter_t it2 = d4_str_split_iter(s1, 1, s2, 1, 2);
+  d4_str_split_iter_t it3 = d4_str_split_iter(s1, 1, s2, 1, -1);
+
+  assert(((void) "Starts at beginning", it1.pos == 0 && !it1.done && it1.str.data == s1.data));
+  assert(((void) "Doesn't limit splits by default", it1.splits == SIZE_MAX));
+  assert(((void) "Limits splits", it2.splits == 2));
+  assert(((void) "Doesn't limit splits when not positive", it3.splits == SIZE_MAX));
+
+  d4_str_free(s1);
+  d4_str_free(s2);
+}
+
+static void test_string_split_iter_next (void) {
+  d4_str_t s1 = d4_str_alloc(L"a::b::::c");
+  d4_str_t s2 = d4_str_alloc(L"::");
+  d4_str_t s3 = d4_str_alloc(L"abc");
+  d4_str_split_iter_t it1 = d4_str_split_iter(s1, 1, s2, 0, 0);
+  d4_str_split_iter_t it2 = d4_str_split_iter(s1, 1, s2, 1, 1);
+  d4_str_split_iter_t it3 = d4_str_split_iter(s3, 1, d4_str_empty_val, 1, 1);
+  d4_str_split_iter_t it4 = d4_str_split_iter(d4_str_empty_val, 1, s2, 0, 0);
+  d4_str_split_iter_t it5 = d4_str_split_iter(d4_str_empty_val, 1, d4_str_empty_val, 0, 0);
+  d4_str_view_t v1;
+
+  assert(((void) "Yields first piece", d4_str_split_iter_next(&it1, &v1) && v1.data == s1.data && v1.len == 1));
+  assert(((void) "Yields second piece", d4_str_split_iter_next(&it1, &v1) && v1.data == &s1.data[3] && v1.len == 1));
+  assert(((void) "Yields empty piece", d4_str_split_iter_next(&it1, &v1) && v1.len == 0));
+  assert(((void) "Yields last piece", d4_str_split_iter_next(&it1, &v1) && v1.data == &s1.data[8] && v1.len == 1));
+  assert(((void) "Stops after last piece", !d4_str_split_iter_next(&it1, &v1)));
+  assert(((void) "Yields piece before limit", d4_str_split_iter_next(&it2, &v1) && v1.len == 1));
+  assert(((void) "Yields rest after limit", d4_str_split_iter_next(&it2, &v1) && v1.len == 6));
+  assert(((void) "Stops after rest", !d4_str_split_iter_next(&it2, &v1)));
+  assert(((void) "Yields character", d4_str_split_iter_next(&it3, &v1) && v1.len == 1 && v1.data[0] == L'a'));
+  assert(((void) "Yields rest of characters", d4_str_split_iter_next(&it3, &v1) && v1.len == 2 && v1.data[0] == L'b'));
+  assert(((void) "Yields empty string once", d4_str_split_iter_next(&it4, &v1) && !d4_str_split_iter_next(&it4, &v1)));
+  assert(((void) "Yields nothing for empty delimiter", !d4_str_split_iter_next(&it5, &v1)));
+
+  d4_str_free(s1);
+  d4_str_free(s2);
+  d4_str_free(s3);
+}
+
+static void test_string_table_alloc (void) {
+  d4_str_t s1 = d4_str_alloc(L"ab");
+  d4_str_t s2 = d4_str_alloc(L"cde");
+  d4_arr_str_t a1 = d4_arr_str_alloc(3, s1, d4_str_empty_val, s2);
+  d4_str_table_t t1 = d4_str_table_alloc(a1);
+  d4_str_table_t t2 = d4_str_table_alloc(d4_arr_str_alloc(0));
+
+  assert(((void) "Packs strings", t1.len == 3 && t1.offsets[3] == 8));
+  assert(((void) "Packs characters contiguously", wmemcmp(t1.data, L"ab\0\0cde\0", 8) == 0));
+  assert(((void) "Packs empty array", t2.len == 0 && t2.data == NULL && t2.offsets[0] == 0));
+
+  d4_str_table_free(t1);
+  d4_str_table_free(t2);
+  d4_arr_str_free(a1);
+  d4_str_free(s1);
+  d4_str_free(s2);
+}
+
+static void test_string_table_at (void) {
+  d4_str_t s1 = d4_str_alloc(L"ab");
+  d4_str_t s2 = d4_str_alloc(L"cde");
+  d4_arr_str_t a1 = d4_arr_str_alloc(2, s1, s2);
+  d4_str_table_t t1 = d4_str_table_alloc(a1);
+
+  ASSERT_NO_THROW(TABLE_AT_1, {
+    d4_str_view_t v1 = d4_str_table_at(&d4_err_state, 0, 0, t1, 1);
+    d4_str_view_t v2 = d4_str_table_at(&d4_err_state, 0, 0, t1, -2);
+
+    assert(((void) "Takes string", v1.data == &t1.data[3] && wcscmp(v1.data, L"cde") == 0));
+    assert(((void) "Takes string from the end", v2.data == t1.data && v2.len == 2));
+  });
+
+  ASSERT_THROW_WITH_MESSAGE(TABLE_AT_2, {
+    d4_str_table_at(&d4_err_state, 0, 0, t1, 2);
+  }, L"index 2 out of table bounds");
+
+  ASSERT_THROW_WITH_MESSAGE(TABLE_AT_3, {
+    d4_str_table_at(&d4_err_state, 0, 0, t1, -3);
+  }, L"index -3 out of table bounds");
+
+  d4_str_table_free(t1);
+  d4_arr_str_free(a1);
+  d4_str_free(s1);
+  d4_str_free(s2);
+}
+
+static void test_string_table_contains (void) {
+  d4_str_t s1 = d4_str_alloc(L"ab");
+  d4_str_t s2 = d4_str_alloc(L"abc");
+  d4_str_t s3 = d4_str_alloc(L"a");
+  d4_arr_str_t a1 = d4_arr_str_alloc(3, s1, d4_str_empty_val, s2);
+  d4_str_table_t t1 = d4_str_table_alloc(a1);
+
+  assert(((void) "Contains string", d4_str_table_contains(t1, s2)));
+  assert(((void) "Contains empty string", d4_str_table_contains(t1, d4_str_empty_val)));
+  assert(((void) "Doesn't contain prefix", !d4_str_table_contains(t1, s3)));
+
+  d4_str_table_free(t1);
+  d4_arr_str_free(a1);
+  d4_str_free(s1);
+  d4_str_free(s2);
+  d4_str_free(s3);
+}
+
+static void test_string_table_free (void) {
+  d4_str_t s1 = d4_str_alloc(L"ab");
+  d4_arr_str_t a1 = d4_arr_str_alloc(1, s1);
+
+  d4_str_table_free(d4_str_table_alloc(a1));
+  d4_str_table_free(d4_str_table_alloc(d4_arr_str_alloc(0)));
+
+  d4_arr_str_free(a1);
+  d4_str_free(s1);
+}
+
+static void test_string_table_join (void) {
+  d4_str_t s1 = d4_str_alloc(L"ab");
+  d4_str_t s2 = d4_str_alloc(L"cde");
+  d4_str_t s3 = d4_str_alloc(L" | ");
+  d4_arr_str_t a1 = d4_arr_str_alloc(3, s1, d4_str_empty_val, s2);
+  d4_str_table_t t1 = d4_str_table_alloc(a1);
+  d4_str_table_t t2 = d4_str_table_alloc(d4_arr_str_alloc(0));
+  d4_str_t r1 = d4_str_table_join(t1, 0, d4_str_empty_val);
+  d4_str_t r2 = d4_str_table_join(t1, 1, s3);
+  d4_str_t r3 = d4_str_table_join(t2, 1, s3);
+
+  assert(((void) "Joins with comma by default", wcscmp(r1.data, L"ab,,cde") == 0 && r1.len == 7));
+  assert(((void) "Joins with separator", wcscmp(r2.data, L"ab |  | cde") == 0));
+  assert(((void) "Joins empty", r3.len == 0));
+
+  d4_str_free(r1);
+  d4_str_free(r2);
+  d4_str_free(r3);
+  d4_str_table_free(t1);
+  d4_str_table_free(t2);
+  d4_arr_str_free(a1);
+  d4_str_free(s1);
+  d4_str_free(s2);
+  d4_str_free(s3);
+}
+
+static void test_string_table_sort (void) {
+  d4_str_t s1 = d4_str_alloc(L"pear");
+  d4_str_t s2 = d4_str_alloc(L"apple");
+  d4_str_t s3 = d4_str_alloc(L"app");
+  d4_arr_str_t a1 = d4_arr_str_alloc(4, s1, s2, d4_str_empty_val, s3);
+  d4_str_table_t t1 = d4_str_table_alloc(a1);
+  d4_str_t r1;
+
+  d4_str_table_sort(&t1);
+  r1 = d4_str_table_join(t1, 0, d4_str_empty_val);
+
+  assert(((void) "Sorts strings", wcscmp(r1.data, L",app,apple,pear") == 0));
+  assert(((void) "Updates offsets", t1.offsets[1] == 1 && t1.offsets[2] == 5 && t1.offsets[4] == 16));
+
+  d4_str_free(r1);
+  d4_str_table_free(t1);
+  d4_arr_str_free(a1);
+  d4_str_free(s1);
+  d4_str_free(s2);
+  d4_str_free(s3);
+}
+
+static void test_string_table_toArr (void) {
+  d4_str_t s1 = d4_str_alloc(L"ab");
+  d4_str_t s2 = d4_str_alloc(L"cde");
+  d4_arr_str_t a1 = d4_arr_str_alloc(2, s1, s2);
+  d4_str_table_t t1 = d4_str_table_alloc(a1);
+  d4_arr_str_t a2 = d4_str_table_toArr(t1);
+
+  assert(((void) "Converts to array", a2.len == 2 && d4_arr_str_eq(a1, a2)));
+  assert(((void) "Converts without copying", a2.data[1].data == &t1.data[3] && a2.data[1].is_static));
+
+  d4_arr_str_free(a2);
+  d4_str_table_free(t1);
+  d4_arr_str_free(a1);
+  d4_str_free(s1);
+  d4_str_free(s2);
+}
+
+static void test_string_toFloat (void) {
+  d4_str_t s1 = d4_str_alloc(L"  -12.5e-1");
+  d4_str_t s2 = d4_str_alloc(L"0x1p3");
+  d4_str_t s3 = d4_str_alloc(L"1e400");
+  d4_str_t s4 = d4_str_alloc(L"1.5x");
+  d4_str_view_t v1 = d4_str_sliceView(s4, 0, 0, 1, 3);
+
+  ASSERT_NO_THROW(TO_FLOAT_1, {
+    assert(((void) "Converts with exponent", d4_str_toFloat(&d4_err_state, 0, 0, s1) == -1.25));
+    assert(((void) "Converts hexadecimal", d4_str_toFloat(&d4_err_state, 0, 0, s2) == 8.0));
+    assert(((void) "Converts view", d4_str_toFloat(&d4_err_state, 0, 0, v1) == 1.5));
+  });
+
+  ASSERT_THROW_WITH_MESSAGE(TO_FLOAT_2, {
+    d4_str_toFloat(&d4_err_state, 0, 0, s3);
+  }, L"value `1e400` out of range");
+
+  ASSERT_THROW_WITH_MESSAGE(TO_FLOAT_3, {
+    d4_str_toFloat(&d4_err_state, 0, 0, s4);
+  }, L"value `1.5x` has invalid syntax");
+
+  d4_str_free(s1);
+  d4_str_free(s2);
+  d4_str_free(s3);
+  d4_str_free(s4);
+}
+
+static void test_string_toFloatAll (void) {
+  d4_str_t s1 = d4_str_alloc(L"1.5");
+  d4_str_t s2 = d4_str_alloc(L"-2");
+  d4_str_t s3 = d4_str_alloc(L"abc");
+  d4_arr_str_t a1 = d4_arr_str_alloc(2, s1, s2);
+  d4_arr_str_t a2 = d4_arr_str_alloc(3, s1, s3, s2);
+  double r1[2];
+  double r2[3] = {0, 0, 0};
+
+  ASSERT_NO_THROW(TO_FLOAT_ALL_1, {
+    d4_str_toFloatAll(&d4_err_state, 0, 0, a1, r1);
+    assert(((void) "Converts every element", r1[0] == 1.5 && r1[1] == -2.0));
+  });
+
+  ASSERT_THROW_WITH_MESSAGE(TO_FLOAT_ALL_2, {
+    d4_str_toFloatAll(&d4_err_state, 0, 0, a2, r2);
+  }, L"value `abc` has invalid syntax");
+
+  assert(((void) "Stops at first invalid element", r2[0] == 1.5 && r2[2] == 0));
+
+  d4_arr_str_free(a1);
+  d4_arr_str_free(a2);
+  d4_str_free(s1);
+  d4_str_free(s2);
+  d4_str_free(s3);
+}
+
+static void test_string_toF32 (void) {
+  d4_str_t s1 = d4_str_alloc(L"0.1");
+  d4_str_t s2 = d4_str_alloc(L"16777217");
+  d4_str_t s3 = d4_str_alloc(L"1e39");
+
+  ASSERT_NO_THROW(TO_F32_1, {
+    assert(((void) "Rounds to nearest", d4_str_toF32(&d4_err_state, 0, 0, s1) == 0.1f));
+    assert(((void) "Rounds halfway to even", d4_str_toF32(&d4_err_state, 0, 0, s2) == 16777216.0f));
+  });
+
+  ASSERT_THROW_WITH_MESSAGE(TO_F32_2, {
+    d4_str_toF32(&d4_err_state, 0, 0, s3);
+  }, L"value `1e39` out of range");
+
+  d4_str_free(s1);
+  d4_str_free(s2);
+  d4_str_free(s3);
+}
+
+static void test_string_toF32All (void) {
+  d4_str_t s1 = d4_str_alloc(L"0.25");
+  d4_str_t s2 = d4_str_alloc(L"3e10");
+  d4_str_t s3 = d4_str_alloc(L"1,5");
+  d4_arr_str_t a1 = d4_arr_str_alloc(2, s1, s2);
+  d4_arr_str_t a2 = d4_arr_str_alloc(3, s1, s3, s2);
+  float r1[2];
+  float r2[3] = {0, 0, 0};
+
+  ASSERT_NO_THROW(TO_F32_ALL_1, {
+    d4_str_toF32All(&d4_err_state, 0, 0, a1, r1);
+    assert(((void) "Converts every element", r1[0] == 0.25f && r1[1] == 3e10f));
+  });
+
+  ASSERT_THROW_WITH_MESSAGE(TO_F32_ALL_2, {
+    d4_str_toF32All(&d4_err_state, 0, 0, a2, r2);
+  }, L"value `1,5` has invalid syntax");
+
+  assert(((void) "Stops at first invalid element", r2[0] == 0.25f && r2[2] == 0));
+
+  d4_arr_str_free(a1);
+  d4_arr_str_free(a2);
+  d4_str_free(s1);
+  d4_str_free(s2);
+  d4_str_free(s3);
+}
+
+static void test_string_toF64 (void) {
+  d4_str_t s1 = d4_str_alloc(L"0.30000000000000004");
+  d4_str_t s2 = d4_str_alloc(L"9007199254740993");
+  d4_str_t s3 = d4_str_alloc(L"-0");
+  d4_str_t s4 = d4_str_alloc(L".");
+  d4_str_t s5 = d4_char_repeat('1', 40);
+
+  ASSERT_NO_THROW(TO_F64_1, {
+    assert(((void) "Converts shortest representation", d4_str_toF64(&d4_err_state, 0, 0, s1) == 0.1 + 0.2));
+    assert(((void) "Rounds halfway to even", d4_str_toF64(&d4_err_state, 0, 0, s2) == 9007199254740992.0));
+    assert(((void) "Converts negative zero", d4_str_toF64(&d4_err_state, 0, 0, s3) == 0.0));
+    assert(((void) "Converts unterminated string on slow path", d4_str_toF64(&d4_err_state, 0, 0, s5) == 1111111111111111111111111111111111111111.0));
+  });
+
+  ASSERT_THROW_WITH_MESSAGE(TO_F64_2, {
+    d4_str_toF64(&d4_err_state, 0, 0, s4);
+  }, L"value `.` has invalid syntax");
+
+  d4_str_free(s1);
+  d4_str_free(s2);
+  d4_str_free(s3);
+  d4_str_free(s4);
+  d4_str_free(s5);
+}
+
+static void test_string_toF64All (void) {
+  d4_str_t s1 = d4_str_alloc(L"123.456");
+  d4_str_t s2 = d4_str_alloc(L"1e-300");
+  d4_str_t s3 = d4_str_alloc(L"1e");
+  d4_arr_str_t a1 = d4_arr_str_alloc(2, s1, s2);
+  d4_arr_str_t a2 = d4_arr_str_alloc(3, s1, s3, s2);
+  double r1[2];
+  double r2[3] = {0, 0, 0};
+
+  ASSERT_NO_THROW(TO_F64_ALL_1, {
+    d4_str_toF64All(&d4_err_state, 0, 0, a1, r1);
+    assert(((void) "Converts every element", r1[0] == 123.456 && r1[1] == 1e-300));
+  });
+
+  ASSERT_THROW_WITH_MESSAGE(TO_F64_ALL_2, {
+    d4_str_toF64All(&d4_err_state, 0, 0, a2, r2);
+  }, L"value `1e` has invalid syntax");
+
+  assert(((void) "Stops at first invalid element", r2[0] == 123.456 && r2[2] == 0));
+
+  d4_arr_str_free(a1);
+  d4_arr_str_free(a2);
+  d4_str_free(s1);
+  d4_str_free(s2);
+  d4_str_free(s3);
+}
+
+static void test_string_toIsize (void) {
+  d4_str_t s1 = d4_str_alloc(L"-9223372036854775808");
+  d4_str_t s2 = d4_str_alloc(L"  +42");
+  d4_str_t s3 = d4_str_alloc(L"9223372036854775808");
+
+  ASSERT_NO_THROW(TO_ISIZE_1, {
+    assert(((void) "Converts minimum", d4_str_toIsize(&d4_err_state, 0, 0, s1, 0, 0) == PTRDIFF_MIN));
+    assert(((void) "Skips leading whitespace and plus sign", d4_str_toIsize(&d4_err_state, 0, 0, s2, 0, 0) == 42));
+  });
+
+  ASSERT_THROW_WITH_MESSAGE(TO_ISIZE_2, {
+    d4_str_toIsize(&d4_err_state, 0, 0, s3, 0, 0);
+  }, L"value `9223372036854775808` out of range");
+
+  d4_str_free(s1);
+  d4_str_free(s2);
+  d4_str_free(s3);
+}
+
+static void test_string_toI8 (void) {
+  d4_str_t s1 = d4_str_alloc(L"-128");
+  d4_str_t s2 = d4_str_alloc(L"127");
+  d4_str_t s3 = d4_str_alloc(L"-0x1f");
+  d4_str_t s4 = d4_str_alloc(L"017");
+  d4_str_t s5 = d4_str_alloc(L"-1010");
+  d4_str_t s6 = d4_str_alloc(L"128");
+  d4_str_t s7 = d4_str_alloc(L"-129");
+  d4_str_t s8 = d4_str_alloc(L"1 2");
+  d4_str_t s9 = d4_str_alloc(L"7");
+
+  ASSERT_NO_THROW(TO_I8_1, {
+    assert(((void) "Converts minimum", d4_str_toI8(&d4_err_state, 0, 0, s1, 0, 0) == INT8_MIN));
+    assert(((void) "Converts maximum", d4_str_toI8(&d4_err_state, 0, 0, s2, 0, 0) == INT8_MAX));
+    assert(((void) "Detects hexadecimal prefix", d4_str_toI8(&d4_err_state, 0, 0, s3, 1, 0) == -31));
+    assert(((void) "Detects octal prefix", d4_str_toI8(&d4_err_state, 0, 0, s4, 1, 0) == 15));
+    assert(((void) "Converts with radix", d4_str_toI8(&d4_err_state, 0, 0, s5, 1, 2) == -10));
+  });
+
+  ASSERT_THROW_WITH_MESSAGE(TO_I8_2, {
+    d4_str_toI8(&d4_err_state, 0, 0, s6, 0, 0);
+  }, L"value `128` out of range");
+
+  ASSERT_THROW_WITH_MESSAGE(TO_I8_3, {
+    d4_str_toI8(&d4_err_state, 0, 0, s7, 0, 0);
+  }, L"value `-129` out of range");
+
+  ASSERT_THROW_WITH_MESSAGE(TO_I8_4, {
+    d4_str_toI8(&d4_err_state, 0, 0, s8, 0, 0);
+  }, L"value `1 2` has invalid syntax");
+
+  ASSERT_THROW_WITH_MESSAGE(TO_I8_5, {
+    d4_str_toI8(&d4_err_state, 0, 0, s9, 1, 1);
+  }, L"radix 1 is invalid, must be >= 2 and <= 36, or 0");
+
+  d4_str_free(s1);
+  d4_str_free(s2);
+  d4_str_free(s3);
+  d4_str_free(s4);
+  d4_str_free(s5);
+  d4_str_free(s6);
+  d4_str_free(s7);
+  d4_str_free(s8);
+  d4_str_free(s9);
+}
+
+static void test_string_toI16 (void) {
+  d4_str_t s1 = d4_str_alloc(L"-32768");
+  d4_str_t s2 = d4_str_alloc(L"ff");
+  d4_str_t s3 = d4_str_alloc(L"32768");
+  d4_str_t s4 = d4_str_alloc(L"");
+
+  ASSERT_NO_THROW(TO_I16_1, {
+    assert(((void) "Converts minimum", d4_str_toI16(&d4_err_state, 0, 0, s1, 0, 0) == INT16_MIN));
+    assert(((void) "Converts hexadecimal", d4_str_toI16(&d4_err_state, 0, 0, s2, 1, 16) == 255));
+  });
+
+  ASSERT_THROW_WITH_MESSAGE(TO_I16_2, {
+    d4_str_toI16(&d4_err_state, 0, 0, s3, 0, 0);
+  }, L"value `32768` out of range");
+
+  ASSERT_THROW_WITH_MESSAGE(TO_I16_3, {
+    d4_str_toI16(&d4_err_state, 0, 0, s4, 0, 0);
+  }, L"value `` has invalid syntax");
+
+  d4_str_free(s1);
+  d4_str_free(s2);
+  d4_str_free(s3);
+  d4_str_free(s4);
+}
+
+static void test_string_toI32 (void) {
+  d4_str_t s1 = d4_str_alloc(L"1234");
+  d4_str_view_t v1 = d4_str_sliceView(s1, 0, 0, 1, 2);
+  d4_str_t s2 = d4_str_alloc(L"12a4");
+  d4_str_view_t v2 = d4_str_sliceView(s2, 0, 0, 1, 3);
+
+  ASSERT_NO_THROW(TO_I32_1, {
+    assert(((void) "Converts view", d4_str_toI32(&d4_err_state, 0, 0, v1, 0, 0) == 12));
+  });
+
+  ASSERT_THROW_WITH_MESSAGE(TO_I32_2, {
+    d4_str_toI32(&d4_err_state, 0, 0, v2, 0, 0);
+  }, L"value `12a` has invalid syntax");
+
+  d4_str_free(s1);
+  d4_str_free(s2);
+}
+
+static void test_string_toI64 (void) {
+  d4_str_t s1 = d4_str_alloc(L"-9223372036854775808");
+  d4_str_t s2 = d4_str_alloc(L"9223372036854775807");
+  d4_str_t s3 = d4_str_alloc(L"0000000000000000000000001");
+  d4_str_t s4 = d4_str_alloc(L"99999999999999999999x");
+  d4_str_t s5 = d4_str_alloc(L"-");
+  d4_str_t s6 = d4_str_alloc(L"0x");
+
+  ASSERT_NO_THROW(TO_I64_1, {
+    assert(((void) "Converts minimum", d4_str_toI64(&d4_err_state, 0, 0, s1, 0, 0) == INT64_MIN));
+    assert(((void) "Converts maximum", d4_str_toI64(&d4_err_state, 0, 0, s2, 0, 0) == INT64_MAX));
+    assert(((void) "Converts leading zeros", d4_str_toI64(&d4_err_state, 0, 0, s3, 0, 0) == 1));
+  });
+
+  ASSERT_THROW_WITH_MESSAGE(TO_I64_2, {
+    d4_str_toI64(&d4_err_state, 0, 0, s4, 0, 0);
+  }, L"value `99999999999999999999x` out of range");
+
+  ASSERT_THROW_WITH_MESSAGE(TO_I64_3, {
+    d4_str_toI64(&d4_err_state, 0, 0, s5, 0, 0);
+  }, L"value `-` has invalid syntax");
+
+  ASSERT_THROW_WITH_MESSAGE(TO_I64_4, {
+    d4_str_toI64(&d4_err_state, 0, 0, s6, 1, 16);
+  }, L"value `0x` has invalid syntax");
+
+  d4_str_free(s1);
+  d4_str_free(s2);
+  d4_str_free(s3);
+  d4_str_free(s4);
+  d4_str_free(s5);
+  d4_str_free(s6);
+}
+
+static void test_string_toUsize (void) {
+  d4_str_t s1 = d4_str_alloc(L"18446744073709551615");
+  d4_str_t s2 = d4_str_alloc(L"18446744073709551616");
+
+  ASSERT_NO_THROW(TO_USIZE_1, {
+    assert(((void) "Converts maximum", d4_str_toUsize(&d4_err_state, 0, 0, s1, 0, 0) == SIZE_MAX));
+  });
+
+  ASSERT_THROW_WITH_MESSAGE(TO_USIZE_2, {
+    d4_str_toUsize(&d4_err_state, 0, 0, s2, 0, 0);
+  }, L"value `18446744073709551616` out of range");
+
+  d4_str_free(s1);
+  d4_str_free(s2);
+}
+
+static void test_string_toU8 (void) {
+  d4_str_t s1 = d4_str_alloc(L"255");
+  d4_str_t s2 = d4_str_alloc(L"\t0");
+  d4_str_t s3 = d4_str_alloc(L"256");
+  d4_str_t s4 = d4_str_alloc(L"-1");
+  d4_str_t s5 = d4_str_alloc(L"-0");
+
+  ASSERT_NO_THROW(TO_U8_1, {
+    assert(((void) "Converts maximum", d4_str_toU8(&d4_err_state, 0, 0, s1, 0, 0) == UINT8_MAX));
+    assert(((void) "Converts zero", d4_str_toU8(&d4_err_state, 0, 0, s2, 0, 0) == 0));
+  });
+
+  ASSERT_THROW_WITH_MESSAGE(TO_U8_2, {
+    d4_str_toU8(&d4_err_state, 0, 0, s3, 0, 0);
+  }, L"value `256` out of range");
+
+  ASSERT_THROW_WITH_MESSAGE(TO_U8_3, {
+    d4_str_toU8(&d4_err_state, 0, 0, s4, 0, 0);
+  }, L"value `-1` out of range");
+
+  ASSERT_THROW_WITH_MESSAGE(TO_U8_4, {
+    d4_str_toU8(&d4_err_state, 0, 0, s5, 0, 0);
+  }, L"value `-0` has invalid syntax");
+
+  d4_str_free(s1);
+  d4_str_free(s2);
+  d4_str_free(s3);
+  d4_str_free(s4);
+  d4_str_free(s5);
+}
+
+static void test_string_toU16 (void) {
+  d4_str_t s1 = d4_str_alloc(L"65535");
+  d4_str_t s2 = d4_str_alloc(L"0XFFFF");
+  d4_str_t s3 = d4_str_alloc(L"65536");
+
+  ASSERT_NO_THROW(TO_U16_1, {
+    assert(((void) "Converts maximum", d4_str_toU16(&d4_err_state, 0, 0, s1, 0, 0) == UINT16_MAX));
+    assert(((void) "Converts hexadecimal prefix", d4_str_toU16(&d4_err_state, 0, 0, s2, 1, 0) == UINT16_MAX));
+  });
+
+  ASSERT_THROW_WITH_MESSAGE(TO_U16_2, {
+    d4_str_toU16(&d4_err_state, 0, 0, s3, 0, 0);
+  }, L"value `65536` out of range");
+
+  d4_str_free(s1);
+  d4_str_free(s2);
+  d4_str_free(s3);
+}
+
+static void test_string_toU32 (void) {
+  d4_str_t s1 = d4_str_alloc(L"4294967295");
+  d4_str_t s2 = d4_str_alloc(L"12345678");
+  d4_str_t s3 = d4_str_alloc(L"4294967296");
+  d4_str_t s4 = d4_str_alloc(L"1234567a");
+
+  ASSERT_NO_THROW(TO_U32_1, {
+    assert(((void) "Converts maximum", d4_str_toU32(&d4_err_state, 0, 0, s1, 0, 0) == UINT32_MAX));
+    assert(((void) "Converts 8 digits", d4_str_toU32(&d4_err_state, 0, 0, s2, 0, 0) == 12345678));
+  });
+
+  ASSERT_THROW_WITH_MESSAGE(TO_U32_2, {
+    d4_str_toU32(&d4_err_state, 0, 0, s3, 0, 0);
+  }, L"value `4294967296` out of range");
+
+  ASSERT_THROW_WITH_MESSAGE(TO_U32_3, {
+    d4_str_toU32(&d4_err_state, 0, 0, s4, 0, 0);
+  }, L"value `1234567a` has invalid syntax");
+
+  d4_str_free(s1);
+  d4_str_free(s2);
+  d4_str_free(s3);
+  d4_str_free(s4);
+}
+
+static void test_string_toU64 (void) {
+  d4_str_t s1 = d4_str_alloc(L"18446744073709551615");
+  d4_str_t s2 = d4_str_alloc(L"1234567890123456789");
+  d4_str_t s3 = d4_str_alloc(L"zz");
+  d4_str_t s4 = d4_str_alloc(L"18446744073709551616");
+  d4_str_t s5 = d4_str_alloc(L"12345678901234567x");
+
+  ASSERT_NO_THROW(TO_U64_1, {
+    assert(((void) "Converts maximum", d4_str_toU64(&d4_err_state, 0, 0, s1, 0, 0) == UINT64_MAX));
+    assert(((void) "Converts in chunks", d4_str_toU64(&d4_err_state, 0, 0, s2, 0, 0) == UINT64_C(1234567890123456789)));
+    assert(((void) "Converts radix 36", d4_str_toU64(&d4_err_state, 0, 0, s3, 1, 36) == 1295));
+  });
+
+  ASSERT_THROW_WITH_MESSAGE(TO_U64_2, {
+    d4_str_toU64(&d4_err_state, 0, 0, s4, 0, 0);
+  }, L"value `18446744073709551616` out of range");
+
+  ASSERT_THROW_WITH_MESSAGE(TO_U64_3, {
+    d4_str_toU64(&d4_err_state, 0, 0, s5, 0, 0);
+  }, L"value `12345678901234567x` has invalid syntax");
+
+  d4_str_free(s1);
+  d4_str_free(s2);
+  d4_str_free(s3);
+  d4_str_free(s4);
+  d4_str_free(s5);
+}
+
+static void test_string_trim (void) {
+  d4_str_t s1 = d4_str_alloc(L"  Hello World \n");
+  d4_str_t s2 = d4_str_alloc(L" \t ");
+  d4_str_t s3 = d4_str_alloc(L"                    \u3000\u00A0Hello\u2003");
+  d4_str_t t1 = d4_str_trim(s1);
+  d4_str_t t2 = d4_str_trim(s2);
+  d4_str_t t3 = d4_str_trim(s3);
+
+  assert(((void) "Trims both ends", wcscmp(t1.data, L"Hello World") == 0));
+  assert(((void) "Trims whitespaces only", t2.len == 0));
+  assert(((void) "Trims non-ASCII whitespaces", wcscmp(t3.data, L"Hello") == 0));
+
+  d4_str_free(t1);
+  d4_str_free(t2);
+  d4_str_free(t3);
+  d4_str_free(s1);
+  d4_str_free(s2);
+  d4_str_free(s3);
+}
+
+static void test_string_trimEnd (void) {
+  d4_str_t s1 = d4_str_alloc(L"  Hello \n");
+  d4_str_t t1 = d4_str_trimEnd(s1);
+
+  assert(((void) "Trims end", wcscmp(t1.data, L"  Hello") == 0));
+
+  d4_str_free(t1);
+  d4_str_free(s1);
+}
+
+static void test_string_trimEndView (void) {
+  d4_str_t s1 = d4_str_alloc(L"  Hello \n");
+  d4_str_view_t v1 = d4_str_trimEndView(s1);
+
+  assert(((void) "Trims end without copying", v1.data == s1.data && v1.len == 7));
+  d4_str_free(s1);
+}
+
+static void test_string_trimInPlace (void) {
+  d4_str_t s1 = d4_str_alloc(L"  Hello World \n");
+  d4_str_t s2 = d4_str_alloc(L" \t ");
+  d4_str_t s3 = d4_str_alloc(L"  Hello  ");
+  d4_str_t s4 = d4_str_copy(s3);
+  wchar_t *d = s1.data;
+
+  s1 = d4_str_trimInPlace(s1);
+  s2 = d4_str_trimInPlace(s2);
+  s3 = d4_str_trimInPlace(s3);
+
+  assert(((void) "Trims in place", s1.data == d && wcscmp(s1.data, L"Hello World") == 0));
+  assert(((void) "Trims whitespaces only", s2.len == 0));
+  assert(((void) "Trims shared", wcscmp(s3.data, L"Hello") == 0 && wcscmp(s4.data, L"  Hello  ") == 0));
+
+  d4_str_free(s1);
+  d4_str_free(s2);
+  d4_str_free(s3);
+  d4_str_free(s4);
+}
+
+static void test_string_trimStart (void) {
+  d4_str_t s1 = d4_str_alloc(L"  Hello \n");
+  d4_str_t t1 = d4_str_trimStart(s1);
+
+  assert(((void) "Trims start", wcscmp(t1.data, L"Hello \n") == 0));
+
+  d4_str_free(t1);
+  d4_str_free(s1);
+}
+
+static void test_string_trimStartView (void) {
+  d4_str_t s1 = d4_str_alloc(L"  Hello \n");
+  d4_str_view_t v1 = d4_str_trimStartView(s1);
+
+  assert(((void) "Trims start without copying", v1.data == &s1.data[2] && v1.len == 7));
+  d4_str_free(s1);
+}
+
+static void test_string_trimView (void) {
+  d4_str_t s1 = d4_str_alloc(L"  Hello \n");
+  d4_str_t s2 = d4_str_alloc(L"Hello");
+  d4_str_view_t v1 = d4_str_trimView(s1);
+  d4_str_view_t v2 = d4_str_trimView(d4_str_empty_val);
+
+  assert(((void) "Trims without copying", v1.data == &s1.data[2] && d4_str_eq(v1, s2)));
+  assert(((void) "Trims empty", v2.len == 0));
+
+  d4_str_free(s1);
+  d4_str_free(s2);
+}
+
+static void test_string_upper (void) {
+  d4_str_t s1 = d4_str_empty_val;
+  d4_str_t s2 = d4_str_alloc(L"Hello World");
+  d4_str_t s3 = d4_str_alloc(L"\u00E9cole \u0434\u043E\u043C");
+  d4_str_t s4 = d4_str_alloc(L"the quick brown fox jumps over \u00E9cole \u0434\u043E\u043C and \u00DF\u00FF @[`{");
+
+  d4_str_t u1 = d4_str_upper(s1);
+  d4_str_t u2 = d4_str_upper(s2);
+  d4_str_t u3 = d4_str_upper(s3);
+  d4_str_t u4 = d4_str_upper(s4);
+
+  assert(((void) "Uppers empty", d4_str_eq(u1, s1)));
+  assert(((void) "Uppers ASCII", wcscmp(u2.data, L"HELLO WORLD") == 0));
+  assert(((void) "Uppers non-ASCII", wcscmp(u3.data, L"\u00C9COLE \u0414\u041E\u041C") == 0));
+  assert(((void) "Uppers mixed", wcscmp(u4.data, L"THE QUICK BROWN FOX JUMPS OVER \u00C9COLE \u0414\u041E\u041C AND \u00DF\u0178 @[`{") == 0));
+
+  d4_str_free(u1);
+  d4_str_free(u2);
+  d4_str_free(u3);
+  d4_str_free(u4);
+  d4_str_free(s1);
+  d4_str_free(s2);
+  d4_str_free(s3);
+  d4_str_free(s4);
+}
+
 static void test_string_upperFirst (void) {
   // todo
 }
 
+static void test_string_upperInPlace (void) {
+  d4_str_t s1 = d4_str_alloc(L"hello \u00E9cole \u00FF");
+  d4_str_t s2 = d4_str_alloc(L"hello");
+  d4_str_t s3 = d4_str_copy(s2);
+  wchar_t *d = s1.data;
+
+  s1 = d4_str_upperInPlace(s1);
+  s2 = d4_str_upperInPlace(s2);
+
+  assert(((void) "Uppers in place", s1.data == d && wcscmp(s1.data, L"HELLO \u00C9COLE \u0178") == 0));
+  assert(((void) "Uppers shared", wcscmp(s2.data, L"HELLO") == 0 && wcscmp(s3.data, L"hello") == 0));
+
+  d4_str_free(s1);
+  d4_str_free(s2);
+  d4_str_free(s3);
+}
+
 int main (void) {
   test_string_snwprintf();
   test_string_vsnwprintf();
+  test_string_arr_sortAsc();
   test_string_alloc();
   test_string_calloc();
+  test_string_appendMove();
   test_string_at();
+  test_string_atMut();
+  test_string_allOf();
+  test_string_builder_alloc();
+  test_string_builder_appendFloat();
+  test_string_builder_appendInt();
+  test_string_builder_appendStr();
+  test_string_builder_appendWchar();
+  test_string_builder_finish();
+  test_string_builder_free();
+  test_string_cmp();
+  test_string_cmpIgnoreCase();
   test_string_concat();
   test_string_contains();
   test_string_copy();
+  test_string_countIf();
   test_string_empty();
   test_string_eq();
+  test_string_eqIgnoreCase();
   test_string_escape();
   test_string_find();
+  test_string_findIgnoreCase();
   test_string_free();
   test_string_ge();
   test_string_gt();
+  test_string_hash();
+  test_string_hash_mutate();
+  test_string_widen_mutate();
+  test_string_intern();
   test_string_le();
   test_string_lines();
+  test_string_lines_iter();
+  test_string_lines_iter_next();
   test_string_lower();
   test_string_lowerFirst();
+  test_string_lowerInPlace();
   test_string_lt();
+  test_string_matcher_alloc();
+  test_string_matcher_findAll();
+  test_string_matcher_free();
+  test_string_matcher_replace();
   test_string_not();
   test_string_quoted_escape();
   test_string_realloc();
   test_string_replace();
+  test_string_replaceInto();
+  test_string_rope_alloc();
+  test_string_rope_append();
+  test_string_rope_at();
+  test_string_rope_concat();
+  test_string_rope_copy();
+  test_string_rope_free();
+  test_string_rope_insert();
+  test_string_rope_iter();
+  test_string_rope_iter_next();
+  test_string_rope_slice();
+  test_string_rope_str();
+  test_string_searcher_alloc();
+  test_string_searcher_count();
+  test_string_searcher_find();
+  test_string_searcher_findAll();
+  test_string_searcher_free();
+  test_string_searcher_replace();
   test_string_slice();
+  test_string_sliceView();
   test_string_split();
+  test_string_splitView();
+  test_string_split_iter();
+  test_string_split_iter_next();
+  test_string_table_alloc();
+  test_string_table_at();
+  test_string_table_contains();
+  test_string_table_free();
+  test_string_table_join();
+  test_string_table_sort();
+  test_string_table_toArr();
   test_string_toFloat();
+  test_string_toFloatAll();
   test_string_toF32();
+  test_string_toF32All();
   test_string_toF64();
+  test_string_toF64All();
   test_string_toIsize();
   test_string_toI8();
   test_string_toI16();
@@ -437,7 +2419,12 @@ int main (void) {
   test_string_toU64();
   test_string_trim();
   test_string_trimEnd();
+  test_string_trimEndView();
+  test_string_trimInPlace();
   test_string_trimStart();
+  test_string_trimStartView();
+  test_string_trimView();
   test_string_upper();
   test_string_upperFirst();
+  test_string_upperInPlace();
 }
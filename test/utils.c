@@ -56,5 +56,5 @@ d4_str_t read_unicode_file (const char *path) {
   }
 
   data[len] = L'\0';
-  return (d4_str_t) {data, len, false};
+  return (d4_str_t) {data, len, false, false};
 }